@@ -0,0 +1,110 @@
+// times each call printing a line on the calling thread, through async_printer and with
+// fprintln, and prints the percentiles of those times, one CSV row per payload, implementation
+// and number of threads
+// lines are pushed one every few microseconds, so that the background thread keeps up
+// and the times are those of pushing rather than of waiting for room in the queue
+#define EZPRINT_ASYNC
+#include "../ezprint.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+struct Point
+{
+    int x, y;
+};
+
+struct Rec
+{
+    Point a, b;
+};
+
+struct NamedRec
+{
+    Rec rec;
+    std::string name;
+};
+
+// discards everything written to it
+struct null_stream : std::ostream
+{
+    struct null_buf : std::streambuf
+    {
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    } buf;
+
+    null_stream() : std::ostream(nullptr) { rdbuf(&buf); }
+};
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr size_t lines_per_thread = 100000;
+constexpr auto gap = std::chrono::microseconds(2);
+
+// calls print lines_per_thread times on each of nthreads threads and returns the time of every call
+template <typename F>
+static std::vector<double> run(size_t nthreads, F print)
+{
+    std::vector<std::vector<double>> times(nthreads);
+    std::vector<std::thread> threads;
+    for(size_t t = 0; t < nthreads; t++)
+        threads.emplace_back([&, t] {
+            auto& ns = times[t];
+            ns.reserve(lines_per_thread);
+            for(size_t i = 0; i < lines_per_thread; i++)
+            {
+                auto start = clock_type::now();
+                print(t, static_cast<int>(i));
+                auto end = clock_type::now();
+                ns.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+                while(clock_type::now() - end < gap)
+                    ;
+            }
+        });
+    for(auto& t : threads)
+        t.join();
+
+    std::vector<double> all;
+    for(auto& ns : times)
+        all.insert(all.end(), ns.begin(), ns.end());
+    return all;
+}
+
+static void report(const char* payload, const char* impl, size_t nthreads, std::vector<double> ns)
+{
+    std::sort(ns.begin(), ns.end());
+    auto at = [&](double q) { return ns[static_cast<size_t>(q * (ns.size() - 1))]; };
+    std::cout << payload << ',' << impl << ',' << nthreads << ',' << at(0.5) << ',' << at(0.99) << ','
+              << at(0.999) << '\n';
+}
+
+template <typename MakePayload>
+static void measure(const char* payload, MakePayload make)
+{
+    for(size_t nthreads : {size_t(1), size_t(4)})
+    {
+        {
+            null_stream os;
+            ez::async_printer printer(os, 4096, ez::overflow_policy::block);
+            auto ns = run(nthreads, [&](size_t, int i) { printer.println(make(i)); });
+            printer.shutdown();
+            report(payload, "async", nthreads, std::move(ns));
+        }
+
+        // one stream per thread, so that the times are those of formatting and writing only
+        std::vector<std::unique_ptr<null_stream>> streams;
+        for(size_t t = 0; t < nthreads; t++)
+            streams.push_back(std::make_unique<null_stream>());
+        report(payload, "fprintln", nthreads,
+               run(nthreads, [&](size_t t, int i) { ez::fprintln(*streams[t], make(i)); }));
+    }
+}
+
+int main()
+{
+    std::cout << "payload,impl,threads,p50_ns,p99_ns,p999_ns\n";
+    measure("Rec", [](int i) { return Rec{{i, -i}, {i * 2, i * 3}}; });
+    measure("NamedRec", [](int i) { return NamedRec{{{i, -i}, {i * 2, i * 3}}, "sensor"}; });
+}
@@ -0,0 +1,255 @@
+// times ez::sprint on each kind of type detail::fprint handles against hand-written ostream
+// and std::format code printing the same text, one CSV row per shape and implementation
+#include "../ezprint.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+
+static size_t allocations = 0;
+
+void* operator new(std::size_t n)
+{
+    allocations++;
+    if(void* p = std::malloc(n ? n : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+struct Point
+{
+    int x, y;
+};
+
+struct Segment
+{
+    Point a, b;
+    std::string name;
+};
+
+// keeps the output of every run alive as far as the optimizer can tell
+static volatile size_t sink = 0;
+
+// runs f until at least 100ms have passed, and prints ns, bytes and allocations per call
+// f returns the printed string, which has to be the same as expected
+template <typename F>
+static void measure(const char* shape, const char* impl, const std::string& expected, F f)
+{
+    if(auto s = f(); s != expected)
+    {
+        std::cerr << shape << ' ' << impl << " printed \"" << s << "\", expected \"" << expected << "\"\n";
+        std::exit(1);
+    }
+
+    using clock = std::chrono::steady_clock;
+    size_t n = 1;
+    while(true)
+    {
+        size_t bytes = 0;
+        auto before = allocations;
+        auto start = clock::now();
+        for(size_t i = 0; i < n; i++)
+        {
+            auto s = f();
+            bytes += s.size();
+        }
+        std::chrono::duration<double, std::nano> elapsed = clock::now() - start;
+        auto allocs = allocations - before;
+        sink = sink + bytes;
+
+        if(elapsed.count() >= 1e8)
+        {
+            std::cout << shape << ',' << impl << ',' << elapsed.count() / n << ',' << double(bytes) / n << ','
+                      << double(allocs) / n << '\n';
+            return;
+        }
+        n *= 2;
+    }
+}
+
+// the same text written with operator<< by hand
+template <typename F>
+static std::string ostream_print(F f)
+{
+    std::ostringstream os;
+    f(os);
+    return os.str();
+}
+
+int main()
+{
+    std::cout << "shape,impl,ns_per_op,bytes_per_op,allocs_per_op\n";
+
+    // streamable leaves
+    {
+        std::string text = "text";
+        auto expected = ez::sprint(42, 3.5, text);
+        measure("leaves", "ez", expected, [&] { return ez::sprint(42, 3.5, text); });
+        measure("leaves", "ostream", expected,
+                [&] { return ostream_print([&](auto& os) { os << 42 << ' ' << 3.5 << ' ' << text; }); });
+#if __cpp_lib_format >= 201907L
+        measure("leaves", "format", expected, [&] { return std::format("{} {} {}", 42, 3.5, text); });
+#endif
+    }
+
+    // numeric range
+    {
+        std::vector<int> v(100);
+        for(int i = 0; i < 100; i++)
+            v[i] = i * 37 - 1000;
+        auto expected = ez::sprint(v);
+        measure("int_range", "ez", expected, [&] { return ez::sprint(v); });
+        measure("int_range", "ostream", expected, [&] {
+            return ostream_print([&](auto& os) {
+                os << '{';
+                for(size_t i = 0; i < v.size(); i++)
+                    os << (i ? " " : "") << v[i];
+                os << '}';
+            });
+        });
+#if __cpp_lib_format >= 201907L
+        measure("int_range", "format", expected, [&] {
+            std::string s = "{";
+            for(size_t i = 0; i < v.size(); i++)
+                std::format_to(std::back_inserter(s), "{}{}", i ? " " : "", v[i]);
+            s += '}';
+            return s;
+        });
+#endif
+    }
+
+    // string range
+    {
+        std::vector<std::string> v;
+        for(int i = 0; i < 50; i++)
+            v.push_back("word" + std::to_string(i));
+        auto expected = ez::sprint(v);
+        measure("string_range", "ez", expected, [&] { return ez::sprint(v); });
+        measure("string_range", "ostream", expected, [&] {
+            return ostream_print([&](auto& os) {
+                os << '{';
+                for(size_t i = 0; i < v.size(); i++)
+                    os << (i ? " " : "") << v[i];
+                os << '}';
+            });
+        });
+#if __cpp_lib_format >= 201907L
+        measure("string_range", "format", expected, [&] {
+            std::string s = "{";
+            for(size_t i = 0; i < v.size(); i++)
+                std::format_to(std::back_inserter(s), "{}{}", i ? " " : "", v[i]);
+            s += '}';
+            return s;
+        });
+#endif
+    }
+
+    // associative container, through the mapped_type path
+    {
+        std::map<int, std::string> m;
+        for(int i = 0; i < 50; i++)
+            m[i * 3] = "value" + std::to_string(i);
+        auto expected = ez::sprint(m);
+        measure("map", "ez", expected, [&] { return ez::sprint(m); });
+        measure("map", "ostream", expected, [&] {
+            return ostream_print([&](auto& os) {
+                os << '{';
+                bool first = true;
+                for(auto& [k, v] : m)
+                {
+                    os << (first ? "" : " ") << k << ": " << v;
+                    first = false;
+                }
+                os << '}';
+            });
+        });
+#if __cpp_lib_format >= 201907L
+        measure("map", "format", expected, [&] {
+            std::string s = "{";
+            bool first = true;
+            for(auto& [k, v] : m)
+            {
+                std::format_to(std::back_inserter(s), "{}{}: {}", first ? "" : " ", k, v);
+                first = false;
+            }
+            s += '}';
+            return s;
+        });
+#endif
+    }
+
+    // tuple
+    {
+        std::tuple t{1, 2.5, 'c', 7u};
+        auto expected = ez::sprint(t);
+        measure("tuple", "ez", expected, [&] { return ez::sprint(t); });
+        measure("tuple", "ostream", expected, [&] {
+            return ostream_print([&](auto& os) {
+                auto& [a, b, c, d] = t;
+                os << '{' << a << ' ' << b << ' ' << c << ' ' << d << '}';
+            });
+        });
+#if __cpp_lib_format >= 201907L
+        measure("tuple", "format", expected, [&] {
+            auto& [a, b, c, d] = t;
+            return std::format("{{{} {} {} {}}}", a, b, c, d);
+        });
+#endif
+    }
+
+    // nested aggregates, through as_tuple
+    {
+        std::vector<Segment> v;
+        for(int i = 0; i < 20; i++)
+            v.push_back({{i, -i}, {i * 2, i * 3}, "s" + std::to_string(i)});
+        auto expected = ez::sprint(v);
+        measure("aggregates", "ez", expected, [&] { return ez::sprint(v); });
+        measure("aggregates", "ostream", expected, [&] {
+            return ostream_print([&](auto& os) {
+                os << '{';
+                for(size_t i = 0; i < v.size(); i++)
+                {
+                    auto& s = v[i];
+                    os << (i ? " " : "") << "{{" << s.a.x << ' ' << s.a.y << "} {" << s.b.x << ' ' << s.b.y
+                       << "} " << s.name << '}';
+                }
+                os << '}';
+            });
+        });
+#if __cpp_lib_format >= 201907L
+        measure("aggregates", "format", expected, [&] {
+            std::string s = "{";
+            for(size_t i = 0; i < v.size(); i++)
+            {
+                auto& g = v[i];
+                std::format_to(std::back_inserter(s), "{}{{{{{} {}}} {{{} {}}} {}}}", i ? " " : "", g.a.x, g.a.y,
+                               g.b.x, g.b.y, g.name);
+            }
+            s += '}';
+            return s;
+        });
+#endif
+    }
+
+#if __cpp_lib_format >= 201907L
+    // format string with an argument std::format can't print, through ez_arg
+    {
+        Point p{1, 2};
+        auto expected = ez::sprintf("{:.2f} {}", 1.5, p);
+        measure("sprintf", "ez", expected, [&] { return ez::sprintf("{:.2f} {}", 1.5, p); });
+        measure("sprintf", "ostream", expected, [&] {
+            return ostream_print([&](auto& os) {
+                os << std::fixed << std::setprecision(2) << 1.5 << " {" << p.x << ' ' << p.y << '}';
+            });
+        });
+        measure("sprintf", "format", expected, [&] { return std::format("{:.2f} {{{} {}}}", 1.5, p.x, p.y); });
+    }
+#endif
+}
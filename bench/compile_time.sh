@@ -0,0 +1,51 @@
+#!/bin/sh
+# times the compiler's frontend on translation units including ezprint.hpp, one CSV row per unit
+# usage: bench/compile_time.sh [header] [runs]
+# the header defaults to the one in this tree, pass another one to compare against it, e.g.
+#   git show <commit>:ezprint.hpp > /tmp/ezprint.hpp && bench/compile_time.sh /tmp/ezprint.hpp
+set -e
+header=$(realpath "${1:-$(dirname "$0")/../ezprint.hpp}")
+runs=${2:-5}
+cxx=${CXX:-c++}
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+
+# a single println of an int
+cat > "$dir/one_line.cpp" <<CPP
+#include "$header"
+int main() { ez::println(1); }
+CPP
+
+# 150 aggregates of 1 to 40 ints, each printed once
+{
+    echo "#include \"$header\""
+    i=0
+    while [ $i -lt 150 ]; do
+        n=$((i % 40 + 1))
+        printf 'struct S%d {' $i
+        j=0
+        while [ $j -lt $n ]; do printf ' int f%d;' $j; j=$((j + 1)); done
+        echo ' };'
+        i=$((i + 1))
+    done
+    echo 'int main()'
+    echo '{'
+    i=0
+    while [ $i -lt 150 ]; do echo "    ez::println(S$i{});"; i=$((i + 1)); done
+    echo '}'
+} > "$dir/aggregates.cpp"
+
+echo "unit,best_s,median_s"
+for unit in one_line aggregates; do
+    times=""
+    r=0
+    while [ $r -lt "$runs" ]; do
+        start=$(date +%s.%N)
+        $cxx -std=c++17 -fsyntax-only "$dir/$unit.cpp"
+        end=$(date +%s.%N)
+        times="$times $(awk -v s="$start" -v e="$end" 'BEGIN { print e - s }')"
+        r=$((r + 1))
+    done
+    echo "$times" | tr ' ' '\n' | sed '/^$/d' | sort -n | awk -v unit=$unit \
+        '{ t[NR] = $1 } END { printf "%s,%.3f,%.3f\n", unit, t[1], t[int((NR + 1) / 2)] }'
+done
@@ -0,0 +1,77 @@
+// times writing lines of strings to a file with ez::dprintln, which hands long strings to writev
+// by reference, against ez::fprintln to a std::ofstream, one CSV row per string size and
+// implementation
+#define EZPRINT_POSIX
+#include "../ezprint.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+// about this many bytes are written by each run
+constexpr size_t total_bytes = size_t(64) << 20;
+
+// best time of a few runs of f, in seconds
+template <typename F>
+static double best_s(F f)
+{
+    double best = 1e300;
+    for(int r = 0; r < 5; r++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+static size_t file_size(const char* path)
+{
+    struct stat st;
+    return ::stat(path, &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+}
+
+int main()
+{
+    char path[] = "/tmp/ezprint_bench_dprint_XXXXXX";
+    int tmp = ::mkstemp(path);
+    if(tmp < 0)
+        return 1;
+    ::close(tmp);
+
+    std::cout << "string_bytes,impl,mb_per_s,ns_per_line\n";
+    for(size_t size : {16, 128, 1024, 4096, 65536})
+    {
+        std::vector<std::string> line;
+        for(int i = 0; i < 16; i++)
+            line.push_back(std::string(size, char('a' + i)));
+        auto line_bytes = ez::formatted_size(line) + 1;
+        auto nlines = total_bytes / line_bytes + 1;
+
+        auto report = [&](const char* impl, double s) {
+            if(file_size(path) != nlines * line_bytes)
+            {
+                std::cerr << impl << " wrote " << file_size(path) << " bytes, expected "
+                          << nlines * line_bytes << '\n';
+                std::exit(1);
+            }
+            std::cout << size << ',' << impl << ',' << nlines * line_bytes / s / 1e6 << ','
+                      << s / nlines * 1e9 << '\n';
+        };
+
+        report("dprintln", best_s([&] {
+                   int fd = ::open(path, O_WRONLY | O_TRUNC);
+                   for(size_t i = 0; i < nlines; i++)
+                       ez::dprintln(fd, line);
+                   ::close(fd);
+               }));
+        report("ofstream", best_s([&] {
+                   std::ofstream f(path, std::ios::trunc);
+                   for(size_t i = 0; i < nlines; i++)
+                       ez::fprintln(f, line);
+               }));
+    }
+    std::remove(path);
+}
@@ -0,0 +1,102 @@
+// times ez::fprint of a large vector of aggregates with and without ez::parallel, with the
+// process restricted to 1, 2, 4, ... of the cores it may run on, one CSV row per core count
+// ez::parallel still starts as many threads as the machine has cores, they only share fewer
+// restricting the cores needs sched_setaffinity, elsewhere only all cores are measured
+#define EZPRINT_THREADS
+#include "../ezprint.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+struct Point
+{
+    int x, y;
+};
+
+struct Segment
+{
+    Point a, b;
+    std::string name;
+};
+
+// discards everything written to it
+struct null_stream : std::ostream
+{
+    struct null_buf : std::streambuf
+    {
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    } buf;
+
+    null_stream() : std::ostream(nullptr) { rdbuf(&buf); }
+};
+
+// best time of a few runs of f, in milliseconds
+template <typename F>
+static double best_ms(F f)
+{
+    double best = 1e300;
+    for(int r = 0; r < 5; r++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+int main()
+{
+    std::vector<Segment> v;
+    for(int i = 0; i < 2000000; i++)
+        v.push_back({{i, -i}, {i * 2, i * 3}, "s" + std::to_string(i % 1000)});
+
+    {
+        std::ostringstream serial, parallel;
+        ez::fprint(serial, v);
+        ez::fprint(ez::parallel, parallel, v);
+        if(serial.str() != parallel.str())
+        {
+            std::cerr << "parallel output differs from the serial one\n";
+            return 1;
+        }
+    }
+
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t allowed;
+    sched_getaffinity(0, sizeof(allowed), &allowed);
+    for(int c = 0; c < CPU_SETSIZE; c++)
+        if(CPU_ISSET(c, &allowed))
+            cpus.push_back(c);
+#endif
+
+    std::vector<size_t> counts;
+    for(size_t n = 1; n < cpus.size(); n *= 2)
+        counts.push_back(n);
+    counts.push_back(cpus.size());
+
+    std::cout << "cores,serial_ms,parallel_ms,speedup\n";
+    null_stream os;
+    for(size_t n : counts)
+    {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for(size_t i = 0; i < n; i++)
+            CPU_SET(cpus[i], &set);
+        sched_setaffinity(0, sizeof(set), &set);
+#endif
+        auto serial = best_ms([&] { ez::fprint(os, v); });
+        auto parallel = best_ms([&] { ez::fprint(ez::parallel, os, v); });
+        std::cout << (cpus.empty() ? std::thread::hardware_concurrency() : n) << ',' << serial << ','
+                  << parallel << ',' << serial / parallel << '\n';
+    }
+}
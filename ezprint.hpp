@@ -1,12 +1,48 @@
 #ifndef EZPRINT_HPP_INCLUDED
 #define EZPRINT_HPP_INCLUDED
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
 #include <experimental/type_traits>
 #include <iostream>
-#include <sstream>
+#include <iterator>
+#include <locale>
+#include <memory>
+#include <optional>
+#include <streambuf>
+#include <string>
+#include <string_view>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
+
+// define EZPRINT_POSIX before including for dprint, dprintf and mmap_sink, where there is
+// <unistd.h>, so that POSIX names are only declared for those who want them
+#if defined(EZPRINT_POSIX) && __has_include(<unistd.h>)
+#define EZPRINT_ENABLE_POSIX 1
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#else
+#define EZPRINT_ENABLE_POSIX 0
+#endif // defined(EZPRINT_POSIX) && __has_include(<unistd.h>)
+
+// defines __cpp_lib_format, which is otherwise only defined by <format> itself
+#if __has_include(<version>)
+#include <version>
+#endif
 
 #if __cpp_lib_format >= 201907L
 #define EZPRINT_ENABLE_FORMAT 1
@@ -15,32 +51,98 @@
 #define EZPRINT_ENABLE_FORMAT 0
 #endif // __cpp_lib_format >= 201907L
 
-namespace ez::detail
+// define EZPRINT_DIRECT_FORMAT before including for ez::formatter and ez::printf to format
+// straight into their output instead of through strings, for ez::printf to apply format
+// specifications to each leaf, and with EZPRINT_STATS to count ez::printf per call site
+#if EZPRINT_ENABLE_FORMAT && defined(EZPRINT_DIRECT_FORMAT)
+#define EZPRINT_ENABLE_DIRECT_FORMAT 1
+#else
+#define EZPRINT_ENABLE_DIRECT_FORMAT 0
+#endif // EZPRINT_ENABLE_FORMAT && defined(EZPRINT_DIRECT_FORMAT)
+
+// define EZPRINT_THREADS before including for ez::atomic and ez::parallel, which most
+// translation units don't need the threading headers for
+#ifdef EZPRINT_THREADS
+#define EZPRINT_ENABLE_THREADS 1
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#else
+#define EZPRINT_ENABLE_THREADS 0
+#endif // EZPRINT_THREADS
+
+// define EZPRINT_ASYNC before including for async_println and async_printer
+#ifdef EZPRINT_ASYNC
+#define EZPRINT_ENABLE_ASYNC 1
+#include <chrono>
+#include <future>
+#include <thread>
+#else
+#define EZPRINT_ENABLE_ASYNC 0
+#endif // EZPRINT_ASYNC
+
+// define EZPRINT_STATS before including to count what is printed, see stats_snapshot
+#ifdef EZPRINT_STATS
+#define EZPRINT_ENABLE_STATS 1
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+#if __has_include(<source_location>)
+#include <source_location>
+#endif
+#else
+#define EZPRINT_ENABLE_STATS 0
+#endif // EZPRINT_STATS
+
+// stats change the inline functions and classes below, which are then defined in a namespace
+// of their own, so that translation units with and without stats don't break the ODR
+#if EZPRINT_ENABLE_STATS
+#define EZPRINT_BEGIN_NAMESPACE namespace ez { inline namespace with_stats {
+#define EZPRINT_END_NAMESPACE } }
+#else
+#define EZPRINT_BEGIN_NAMESPACE namespace ez {
+#define EZPRINT_END_NAMESPACE }
+#endif // EZPRINT_ENABLE_STATS
+
+EZPRINT_BEGIN_NAMESPACE
+namespace detail
 {
-    inline constexpr size_t max_fields = 64;
+    inline constexpr size_t max_fields = 128;
 
-    // as_tuple returns the fields of an aggregate as a tuple, in order
-    template <typename T>
-    inline auto as_tuple(T&&, std::integral_constant<size_t, 0>)
+    // fields<N>::get returns the fields of an aggregate with N fields, see as_tuple
+    // a class template, so that picking one takes a lookup instead of overload resolution
+    template <size_t N>
+    struct fields;
+
+    template <>
+    struct fields<0>
     {
-        return std::tuple{};
-    }
+        template <typename T>
+        static auto get(T&)
+        {
+            return std::tuple{};
+        }
+    };
 
     // Overlaying a tuple onto the object violates strict-aliasing, requires a custom tuple
     // implementation to ensure layout and has problems with nested/enum/non-pod types.
     // In short, it was a very risky way of doing things unsatisfactorily prior C++17.
     // So instead we brute force with "all" possible field counts with structured bindings.
     // Unfortunately, this means we have a limit on field counts.
-    // Current limit of 64 has absolutely no reason whatsoever, 42 might have been better. Ah well.
+    // Current limit of 128 has absolutely no reason whatsoever, 42 might have been better. Ah well.
     // The macro is undefined at the end.
     // Returns the fields as a tuple of lvalue references to them, in order.
 #define DEFINE_AS_TUPLE(N, ...)                                                                    \
-    template <typename T>                                                                          \
-    inline auto as_tuple(T&& t, std::integral_constant<size_t, N>)                                 \
+    template <>                                                                                    \
+    struct fields<N>                                                                               \
     {                                                                                              \
-        auto& [__VA_ARGS__] = t;                                                                   \
-        return std::forward_as_tuple(__VA_ARGS__);                                                 \
-    }
+        template <typename T>                                                                      \
+        static auto get(T& t)                                                                      \
+        {                                                                                          \
+            auto& [__VA_ARGS__] = t;                                                               \
+            return std::forward_as_tuple(__VA_ARGS__);                                             \
+        }                                                                                          \
+    };
 
     DEFINE_AS_TUPLE(1, x0)
     DEFINE_AS_TUPLE(2, x0, x1)
@@ -199,12 +301,443 @@ namespace ez::detail
                     x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
                     x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
                     x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63)
+    DEFINE_AS_TUPLE(65, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64)
+    DEFINE_AS_TUPLE(66, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65)
+    DEFINE_AS_TUPLE(67, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66)
+    DEFINE_AS_TUPLE(68, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67)
+    DEFINE_AS_TUPLE(69, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68)
+    DEFINE_AS_TUPLE(70, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69)
+    DEFINE_AS_TUPLE(71, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70)
+    DEFINE_AS_TUPLE(72, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71)
+    DEFINE_AS_TUPLE(73, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72)
+    DEFINE_AS_TUPLE(74, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73)
+    DEFINE_AS_TUPLE(75, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74)
+    DEFINE_AS_TUPLE(76, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75)
+    DEFINE_AS_TUPLE(77, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76)
+    DEFINE_AS_TUPLE(78, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77)
+    DEFINE_AS_TUPLE(79, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78)
+    DEFINE_AS_TUPLE(80, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79)
+    DEFINE_AS_TUPLE(81, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80)
+    DEFINE_AS_TUPLE(82, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81)
+    DEFINE_AS_TUPLE(83, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82)
+    DEFINE_AS_TUPLE(84, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83)
+    DEFINE_AS_TUPLE(85, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84)
+    DEFINE_AS_TUPLE(86, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85)
+    DEFINE_AS_TUPLE(87, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86)
+    DEFINE_AS_TUPLE(88, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87)
+    DEFINE_AS_TUPLE(89, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88)
+    DEFINE_AS_TUPLE(90, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89)
+    DEFINE_AS_TUPLE(91, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90)
+    DEFINE_AS_TUPLE(92, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91)
+    DEFINE_AS_TUPLE(93, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92)
+    DEFINE_AS_TUPLE(94, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93)
+    DEFINE_AS_TUPLE(95, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94)
+    DEFINE_AS_TUPLE(96, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95)
+    DEFINE_AS_TUPLE(97, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96)
+    DEFINE_AS_TUPLE(98, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97)
+    DEFINE_AS_TUPLE(99, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98)
+    DEFINE_AS_TUPLE(100, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99)
+    DEFINE_AS_TUPLE(101, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100)
+    DEFINE_AS_TUPLE(102, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101)
+    DEFINE_AS_TUPLE(103, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102)
+    DEFINE_AS_TUPLE(104, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103)
+    DEFINE_AS_TUPLE(105, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104)
+    DEFINE_AS_TUPLE(106, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104, x105)
+    DEFINE_AS_TUPLE(107, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104, x105, x106)
+    DEFINE_AS_TUPLE(108, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104, x105, x106, x107)
+    DEFINE_AS_TUPLE(109, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104, x105, x106, x107, x108)
+    DEFINE_AS_TUPLE(110, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104, x105, x106, x107, x108, x109)
+    DEFINE_AS_TUPLE(111, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104, x105, x106, x107, x108, x109, x110)
+    DEFINE_AS_TUPLE(112, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104, x105, x106, x107, x108, x109, x110, x111)
+    DEFINE_AS_TUPLE(113, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104, x105, x106, x107, x108, x109, x110, x111, x112)
+    DEFINE_AS_TUPLE(114, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104, x105, x106, x107, x108, x109, x110, x111, x112,
+                    x113)
+    DEFINE_AS_TUPLE(115, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104, x105, x106, x107, x108, x109, x110, x111, x112,
+                    x113, x114)
+    DEFINE_AS_TUPLE(116, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104, x105, x106, x107, x108, x109, x110, x111, x112,
+                    x113, x114, x115)
+    DEFINE_AS_TUPLE(117, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104, x105, x106, x107, x108, x109, x110, x111, x112,
+                    x113, x114, x115, x116)
+    DEFINE_AS_TUPLE(118, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104, x105, x106, x107, x108, x109, x110, x111, x112,
+                    x113, x114, x115, x116, x117)
+    DEFINE_AS_TUPLE(119, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104, x105, x106, x107, x108, x109, x110, x111, x112,
+                    x113, x114, x115, x116, x117, x118)
+    DEFINE_AS_TUPLE(120, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104, x105, x106, x107, x108, x109, x110, x111, x112,
+                    x113, x114, x115, x116, x117, x118, x119)
+    DEFINE_AS_TUPLE(121, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104, x105, x106, x107, x108, x109, x110, x111, x112,
+                    x113, x114, x115, x116, x117, x118, x119, x120)
+    DEFINE_AS_TUPLE(122, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104, x105, x106, x107, x108, x109, x110, x111, x112,
+                    x113, x114, x115, x116, x117, x118, x119, x120, x121)
+    DEFINE_AS_TUPLE(123, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104, x105, x106, x107, x108, x109, x110, x111, x112,
+                    x113, x114, x115, x116, x117, x118, x119, x120, x121, x122)
+    DEFINE_AS_TUPLE(124, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104, x105, x106, x107, x108, x109, x110, x111, x112,
+                    x113, x114, x115, x116, x117, x118, x119, x120, x121, x122, x123)
+    DEFINE_AS_TUPLE(125, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104, x105, x106, x107, x108, x109, x110, x111, x112,
+                    x113, x114, x115, x116, x117, x118, x119, x120, x121, x122, x123, x124)
+    DEFINE_AS_TUPLE(126, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104, x105, x106, x107, x108, x109, x110, x111, x112,
+                    x113, x114, x115, x116, x117, x118, x119, x120, x121, x122, x123, x124, x125)
+    DEFINE_AS_TUPLE(127, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104, x105, x106, x107, x108, x109, x110, x111, x112,
+                    x113, x114, x115, x116, x117, x118, x119, x120, x121, x122, x123, x124, x125, x126)
+    DEFINE_AS_TUPLE(128, x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15, x16,
+                    x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31, x32,
+                    x33, x34, x35, x36, x37, x38, x39, x40, x41, x42, x43, x44, x45, x46, x47, x48,
+                    x49, x50, x51, x52, x53, x54, x55, x56, x57, x58, x59, x60, x61, x62, x63, x64,
+                    x65, x66, x67, x68, x69, x70, x71, x72, x73, x74, x75, x76, x77, x78, x79, x80,
+                    x81, x82, x83, x84, x85, x86, x87, x88, x89, x90, x91, x92, x93, x94, x95, x96,
+                    x97, x98, x99, x100, x101, x102, x103, x104, x105, x106, x107, x108, x109, x110, x111, x112,
+                    x113, x114, x115, x116, x117, x118, x119, x120, x121, x122, x123, x124, x125, x126, x127)
 
 #undef DEFINE_AS_TUPLE
-} // namespace ez::detail
 
-namespace ez
-{
+    // as_tuple returns the fields of an aggregate as a tuple, in order
+    template <typename T, size_t N>
+    inline auto as_tuple(T&& t, std::integral_constant<size_t, N>)
+    {
+        return fields<N>::get(t);
+    }
+} // namespace detail
+EZPRINT_END_NAMESPACE
+
+EZPRINT_BEGIN_NAMESPACE
+    // bounds on how much of a value is printed, elided parts are marked with ...
+    // ranges print at most max_elements_per_range elements, followed by the number of
+    // elided elements if the range has a size
+    // values nested deeper than max_depth print as {...}
+    // the output is cut after max_total_bytes characters
+    struct limits
+    {
+        std::size_t max_elements_per_range = SIZE_MAX;
+        std::size_t max_depth = SIZE_MAX;
+        std::size_t max_total_bytes = SIZE_MAX;
+    };
+
     namespace detail
     {
         using std::size_t;
@@ -253,16 +786,50 @@ namespace ez
             count_r<T, Ubiqs...>(sz, 0);
         }
 
+        // whether T can be initialized from a pack of ubiqs as long as Is
+        template <typename T, typename Is, typename = void>
+        inline constexpr bool ubiq_init_v = false;
+        template <typename T, size_t... Is>
+        inline constexpr bool ubiq_init_v<T, std::index_sequence<Is...>, std::void_t<decltype(T{ubiq_t<Is>{}...})>> = true;
+
+        template <typename T, size_t N>
+        inline constexpr bool ubiq_init_n_v = ubiq_init_v<T, std::make_index_sequence<N>>;
+
+        // binary search for the most ubiqs in [Lo, Hi] that T can be initialized from
+        // T can be initialized from as many ubiqs as it has fields, from more never, and from
+        // fewer unless some of the fields left out can't be initialized from {}, so the result
+        // is only correct if T can be initialized from it
+        template <typename T, size_t Lo, size_t Hi>
+        inline constexpr size_t count_search()
+        {
+            if constexpr(Lo == Hi)
+                return Lo;
+            else
+            {
+                constexpr size_t mid = (Lo + Hi + 1) / 2;
+                if constexpr(ubiq_init_n_v<T, mid>)
+                    return count_search<T, mid, Hi>();
+                else
+                    return count_search<T, Lo, mid - 1>();
+            }
+        }
+
         // returns number of fields in T
         // number of fields in T muts be less than sizeof(T)
         template <typename T>
         inline constexpr auto count()
         {
-            return index_upto<std::min(sizeof(T), max_fields)>([](auto... is) {
-                size_t sz = 0;
-                count_r<T, ubiq_t<is>...>(sz, 0);
-                return sz;
-            });
+            constexpr size_t max = std::min(sizeof(T), max_fields);
+            constexpr size_t n = count_search<T, 0, max>();
+            if constexpr(ubiq_init_n_v<T, n>)
+                return n;
+            else
+                // fields that can't be initialized from {} threw off the search, count linearly
+                return index_upto<max>([](auto... is) {
+                    size_t sz = 0;
+                    count_r<T, ubiq_t<is>...>(sz, 0);
+                    return sz;
+                });
         }
 
         template <typename T>
@@ -290,108 +857,3186 @@ namespace ez
         using mapped_type = typename T::mapped_type;
         template <typename T>
         using tuple_size_t = typename std::tuple_size<T>::type;
+        template <typename T>
+        using data_t = decltype(std::data(std::declval<T>()));
+        template <typename T>
+        using container_size_t = decltype(std::size(std::declval<T>()));
+        template <typename It>
+        using bulk_write_t = decltype(std::declval<It&>().write(std::string_view{}));
+        template <typename It>
+        using ref_write_t = decltype(std::declval<It&>().write_ref(std::string_view{}));
+        template <typename It>
+        using char_output_t = decltype(*std::declval<It&>() = 'c', ++std::declval<It&>());
+        // the output iterators format_to and format_to_n take, so that argument dependent lookup
+        // of a format_to with anything else as its first argument doesn't find them
+        template <typename It, typename R>
+        using if_char_output_t = std::enable_if_t<std::experimental::is_detected_v<char_output_t, It>, R>;
 
         template <typename T>
-        inline void fprint(std::ostream& os, T&& t)
-        {
-            // T is always a lvalue reference
-            using rT = std::remove_reference_t<T>;
+        inline constexpr bool is_char_ptr_v =
+            std::is_pointer_v<std::decay_t<T>> &&
+            std::is_same_v<std::remove_cv_t<std::remove_pointer_t<std::decay_t<T>>>, char>;
 
-            // order of if is important, the desired behaviour is to supply alternative
-            // printing formats only when the most natural isn't available
-            if constexpr(std::experimental::is_detected_v<stream_t, T> && (!std::is_array_v<rT> || is_string_v<rT>))
-                os << t;
-            else if constexpr(std::experimental::is_detected_v<begin_t, T> &&
-                              std::experimental::is_detected_v<end_t, T>)
-            {
-                int i = 0;
-                os << '{';
-                for(auto&& x : t)
-                {
-                    if(i > 0)
-                        os << ' ';
+#if __cpp_lib_to_chars >= 201611L
+        inline constexpr bool has_float_to_chars = true;
+#else
+        inline constexpr bool has_float_to_chars = false;
+#endif // __cpp_lib_to_chars >= 201611L
 
-                    // this is a somewhat special case, where the presence of mapped_type is
-                    // taken as being an associative container
-                    if constexpr(std::experimental::is_detected_v<mapped_type, rT>)
-                    {
-                        fprint(os, x.first);
-                        os << ": ";
-                        fprint(os, x.second);
-                    }
-                    else
-                        fprint(os, x);
+        // numbers are the arithmetic types written with to_chars instead of operator<<
+        // character types are excluded, operator<< prints them as characters
+        template <typename T>
+        inline constexpr bool is_number_v =
+            std::is_arithmetic_v<T> &&
+            !is_string_of_v<T, char, signed char, unsigned char, wchar_t, char8_t, char16_t, char32_t> &&
+            (std::is_integral_v<T> || has_float_to_chars);
 
-                    i++;
-                }
-                os << '}';
-            }
-            else if constexpr(std::experimental::is_detected_v<tuple_size_t, rT>)
+        // ranges whose elements are numbers laid out contiguously, eg vector<double>
+        template <typename T, typename = void>
+        inline constexpr bool is_contiguous_numbers_v = false;
+        template <typename T>
+        inline constexpr bool is_contiguous_numbers_v<
+            T, std::enable_if_t<std::experimental::is_detected_v<data_t, T> &&
+                                std::experimental::is_detected_v<container_size_t, T>>> =
+            std::is_pointer_v<data_t<T>> &&
+            is_number_v<std::remove_cv_t<std::remove_pointer_t<data_t<T>>>>;
+
+        // no number written by write_number is longer than this
+        inline constexpr size_t max_number_chars = 64;
+
+        // writes n exactly as operator<< does with default flags and the classic locale,
+        // floating points are printed as %g with precision 6
+        // first must have room for max_number_chars characters
+        template <typename T>
+        inline char* write_number(char* first, T n)
+        {
+            char* last = first + max_number_chars;
+            if constexpr(std::is_same_v<T, bool>)
             {
-                constexpr auto len = std::tuple_size_v<rT>;
-                if constexpr(len > 0)
-                    index_upto<len>([&](auto, auto... is) {
-                        os << '{';
-                        fprint(os, get<0>(t));
-                        (fprint(os << ' ', get<decltype(is){}>(t)), ...);
-                        os << '}';
-                    });
-                else
-                    os << "{}";
+                *first = n ? '1' : '0';
+                return first + 1;
             }
-            else if constexpr(std::is_aggregate_v<rT>)
-                fprint(os, as_tuple(t, count_t<rT>{}));
+            else if constexpr(std::is_same_v<T, float>)
+                return std::to_chars(first, last, static_cast<double>(n), std::chars_format::general, 6).ptr;
+            else if constexpr(std::is_floating_point_v<T>)
+                return std::to_chars(first, last, n, std::chars_format::general, 6).ptr;
             else
-                os << "!(UNKNOWN TYPE)";
+                return std::to_chars(first, last, n).ptr;
         }
 
-        template <typename T, typename... Ts>
-        inline void fprint(std::ostream& os, T&& t, Ts&&... ts)
+        // number of characters write_number writes, in closed form for integers
+        template <typename T>
+        inline size_t count_number(T n)
         {
-            fprint(os, t);
-            (fprint(os << ' ', ts), ...);
+            if constexpr(std::is_integral_v<T> && !std::is_same_v<T, bool>)
+            {
+                using uT = std::make_unsigned_t<T>;
+                size_t len = n < 0 ? 2 : 1;
+                uT u = n < 0 ? uT(0) - uT(n) : uT(n);
+                for(; u >= 10000; u /= 10000)
+                    len += 4;
+                return len + (u >= 10) + (u >= 100) + (u >= 1000);
+            }
+            else
+            {
+                char buf[max_number_chars];
+                return write_number(buf, n) - buf;
+            }
         }
 
-        inline void fprint(std::ostream&) {}
+        // true if loc prints numbers with the same facets as the classic locale, e.g. when only
+        // its other categories were taken from another locale
+        // compared by identity, since comparing locales can build their names
+        inline bool is_classic_numeric(const std::locale& loc)
+        {
+            static const auto* punct = &std::use_facet<std::numpunct<char>>(std::locale::classic());
+            static const auto* put = &std::use_facet<std::num_put<char>>(std::locale::classic());
+            return &std::use_facet<std::numpunct<char>>(loc) == punct && &std::use_facet<std::num_put<char>>(loc) == put;
+        }
 
-    } // namespace detail
+        // the same for the locale of os, kept in a word of os until it is imbued again
+        // once set the word is only read, also by several threads printing like os
+        inline bool is_classic_numeric(std::ios_base& os)
+        {
+            // 0 before the first call, 1 or 2 for classic or not, 3 after imbue
+            static const int index = std::ios_base::xalloc();
+            long& word = os.iword(index);
+            if(word == 0)
+                os.register_callback(
+                    [](std::ios_base::event e, std::ios_base& os, int index) {
+                        if(e == std::ios_base::imbue_event)
+                            os.iword(index) = 3;
+                    },
+                    index);
+            if(word == 0 || word == 3)
+                word = is_classic_numeric(os.getloc()) ? 1 : 2;
+            return word == 1;
+        }
 
-    template <typename... Ts>
-    inline void fprint(std::ostream& os, Ts&&... ts)
-    {
-        detail::fprint(os, std::forward<Ts>(ts)...);
-    }
+        // true if os prints numbers the same as write_number
+        inline bool is_plain_numeric(const std::ios_base& os)
+        {
+            constexpr auto ignored = std::ios_base::skipws | std::ios_base::unitbuf;
+            return (os.flags() & ~ignored) == std::ios_base::dec && os.precision() == 6 &&
+                   os.width() == 0;
+        }
 
-    template <typename... Ts>
-    inline void fprintln(std::ostream& os, Ts&&... ts)
-    {
-        fprint(os, std::forward<Ts>(ts)...);
-        os << '\n';
-    }
+        // streambuf forwarding everything to an output iterator
+        // only used for types that have nothing but an operator<<
+        template <typename It>
+        class iterator_streambuf : public std::streambuf
+        {
+        public:
+            explicit iterator_streambuf(It& out) : out(out) {}
 
-    template <typename... Ts>
-    inline void print(Ts&&... ts)
-    {
-        fprint(std::cout, std::forward<Ts>(ts)...);
-    }
+        protected:
+            int_type overflow(int_type c) override
+            {
+                if(!traits_type::eq_int_type(c, traits_type::eof()))
+                {
+                    *out = traits_type::to_char_type(c);
+                    ++out;
+                }
+                return traits_type::not_eof(c);
+            }
 
-    template <typename... Ts>
-    inline void println(Ts&&... ts)
-    {
-        fprint(std::cout, std::forward<Ts>(ts)...);
-        std::cout << '\n';
-    }
+            std::streamsize xsputn(const char* s, std::streamsize n) override
+            {
+                out = std::copy_n(s, n, out);
+                return n;
+            }
 
-    template <typename... Ts>
-    inline std::string sprint(Ts&&... ts)
-    {
-        std::stringstream ss;
-        fprint(ss, std::forward<Ts>(ts)...);
-        return ss.str();
-    }
+        private:
+            It& out;
+        };
 
-#if EZPRINT_ENABLE_FORMAT
-    namespace detail
+        // exposes the container of a back_insert_iterator, which is a protected member
+        template <typename C>
+        struct back_insert_access : std::back_insert_iterator<C>
+        {
+            static C& get(std::back_insert_iterator<C>& it)
+            {
+                return *(it.*&back_insert_access::container);
+            }
+        };
+
+        // output iterator that discards everything, only counting the characters
+        struct counting_iterator
+        {
+            using iterator_category = std::output_iterator_tag;
+            using value_type = void;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = void;
+
+            counting_iterator& operator*() { return *this; }
+            counting_iterator& operator=(char) { return *this; }
+            counting_iterator& operator++()
+            {
+                n++;
+                return *this;
+            }
+            counting_iterator operator++(int)
+            {
+                auto ret = *this;
+                n++;
+                return ret;
+            }
+
+            size_t n = 0;
+        };
+
+        // output iterator counting all characters, forwarding only the first limit of them
+        template <typename It>
+        struct truncating_iterator
+        {
+            using iterator_category = std::output_iterator_tag;
+            using value_type = void;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = void;
+
+            truncating_iterator(It out, size_t limit) : out(out), limit(limit) {}
+
+            truncating_iterator& operator*() { return *this; }
+            truncating_iterator& operator=(char c)
+            {
+                if(n < limit)
+                {
+                    *out = c;
+                    ++out;
+                }
+                return *this;
+            }
+            truncating_iterator& operator++()
+            {
+                n++;
+                return *this;
+            }
+            truncating_iterator operator++(int)
+            {
+                auto ret = *this;
+                n++;
+                return ret;
+            }
+
+            It out;
+            size_t limit;
+            size_t n = 0;
+        };
+
+        // counting_iterator that also tells if everything written is ASCII,
+        // in which case the length is also the width std::format pads to
+        struct ascii_counting_iterator
+        {
+            using iterator_category = std::output_iterator_tag;
+            using value_type = void;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = void;
+
+            ascii_counting_iterator& operator*() { return *this; }
+            ascii_counting_iterator& operator=(char c)
+            {
+                ascii = ascii && static_cast<unsigned char>(c) < 0x80;
+                return *this;
+            }
+            ascii_counting_iterator& operator++()
+            {
+                n++;
+                return *this;
+            }
+            ascii_counting_iterator operator++(int)
+            {
+                auto ret = *this;
+                n++;
+                return ret;
+            }
+
+            size_t n = 0;
+            bool ascii = true;
+        };
+
+        template <typename It>
+        inline It copy_chars(std::string_view s, It out);
+
+        template <typename It>
+        inline truncating_iterator<It> copy_chars(std::string_view s, truncating_iterator<It> out)
+        {
+            if(out.n <= out.limit && s.size() <= out.limit - out.n)
+                out.out = copy_chars(s, out.out);
+            else if(out.n < out.limit)
+                out.out = copy_chars(s.substr(0, out.limit - out.n), out.out);
+            out.n += s.size();
+            return out;
+        }
+
+        template <typename It>
+        inline It copy_chars(std::string_view s, It out)
+        {
+            if constexpr(std::is_same_v<It, std::back_insert_iterator<std::string>>)
+            {
+                auto& str = back_insert_access<std::string>::get(out);
+                // push_back is inlined, append isn't
+                if(s.size() <= 4)
+                    for(char c : s)
+                        str.push_back(c);
+                else
+                    str.append(s);
+                return out;
+            }
+            else if constexpr(std::is_same_v<It, counting_iterator>)
+            {
+                out.n += s.size();
+                return out;
+            }
+            else if constexpr(std::is_same_v<It, ascii_counting_iterator>)
+            {
+                for(char c : s)
+                    out.ascii = out.ascii && static_cast<unsigned char>(c) < 0x80;
+                out.n += s.size();
+                return out;
+            }
+            else if constexpr(std::experimental::is_detected_v<bulk_write_t, It>)
+            {
+                out.write(s);
+                return out;
+            }
+            else
+                return std::copy_n(s.data(), s.size(), out);
+        }
+
+        inline void write_all(std::FILE* f, std::string_view s)
+        {
+            std::fwrite(s.data(), 1, s.size(), f);
+        }
+
+#if EZPRINT_ENABLE_POSIX
+        // a file descriptor, wrapped to not be confused with an int
+        struct fd_sink
+        {
+            int fd;
+        };
+
+        inline void write_all(fd_sink f, std::string_view s)
+        {
+            while(!s.empty())
+            {
+                auto n = ::write(f.fd, s.data(), s.size());
+                if(n < 0 && errno == EINTR)
+                    continue;
+                if(n <= 0)
+                    return;
+                s.remove_prefix(n);
+            }
+        }
+#endif // EZPRINT_ENABLE_POSIX
+
+#if EZPRINT_ENABLE_DIRECT_FORMAT
+        // buffer on the stack, emptied into sink with write_all when full and when destroyed
+        template <typename Sink>
+        class sink_buffer
+        {
+        public:
+            explicit sink_buffer(Sink sink) : sink(sink) {}
+            sink_buffer(const sink_buffer&) = delete;
+            sink_buffer& operator=(const sink_buffer&) = delete;
+            ~sink_buffer() { flush(); }
+
+            class iterator
+            {
+            public:
+                using iterator_category = std::output_iterator_tag;
+                using value_type = void;
+                using difference_type = std::ptrdiff_t;
+                using pointer = void;
+                using reference = void;
+
+                explicit iterator(sink_buffer& b) : b(&b) {}
+
+                iterator& operator*() { return *this; }
+                iterator& operator=(char c)
+                {
+                    b->put(c);
+                    return *this;
+                }
+                iterator& operator++() { return *this; }
+                iterator operator++(int) { return *this; }
+
+                void write(std::string_view s) { b->write(s); }
+
+            private:
+                sink_buffer* b;
+            };
+
+            iterator begin() { return iterator(*this); }
+
+            void put(char c)
+            {
+                if(n == sizeof(buf))
+                    flush();
+                buf[n++] = c;
+            }
+
+            void write(std::string_view s)
+            {
+                if(s.size() > sizeof(buf) - n)
+                {
+                    flush();
+                    if(s.size() >= sizeof(buf))
+                        return write_all(sink, s);
+                }
+                std::memcpy(buf + n, s.data(), s.size());
+                n += s.size();
+            }
+
+            void flush()
+            {
+                write_all(sink, {buf, n});
+                n = 0;
+            }
+
+        private:
+            Sink sink;
+            char buf[4096];
+            size_t n = 0;
+        };
+#endif // EZPRINT_ENABLE_DIRECT_FORMAT
+
+#if EZPRINT_ENABLE_POSIX
+        // gathers the output for writev on a file descriptor
+        // short pieces are copied into a buffer, long strings passed to write_ref are only
+        // referenced and must stay alive until flush
+        class gather_buffer
+        {
+        public:
+            explicit gather_buffer(int fd) : fd(fd) {}
+            gather_buffer(const gather_buffer&) = delete;
+            gather_buffer& operator=(const gather_buffer&) = delete;
+            ~gather_buffer() { flush(); }
+
+            class iterator
+            {
+            public:
+                using iterator_category = std::output_iterator_tag;
+                using value_type = void;
+                using difference_type = std::ptrdiff_t;
+                using pointer = void;
+                using reference = void;
+
+                explicit iterator(gather_buffer& b) : b(&b) {}
+
+                iterator& operator*() { return *this; }
+                iterator& operator=(char c)
+                {
+                    b->put(c);
+                    return *this;
+                }
+                iterator& operator++() { return *this; }
+                iterator operator++(int) { return *this; }
+
+                void write(std::string_view s) { b->write(s); }
+                void write_ref(std::string_view s) { b->write_ref(s); }
+
+            private:
+                gather_buffer* b;
+            };
+
+            iterator begin() { return iterator(*this); }
+
+            void put(char c)
+            {
+                if(n == sizeof(buf))
+                    flush();
+                buf[n++] = c;
+            }
+
+            void write(std::string_view s)
+            {
+                if(s.size() > sizeof(buf) - n)
+                {
+                    flush();
+                    if(s.size() >= sizeof(buf))
+                        return write_all(fd_sink{fd}, s);
+                }
+                std::memcpy(buf + n, s.data(), s.size());
+                n += s.size();
+            }
+
+            void write_ref(std::string_view s)
+            {
+                if(s.size() < min_ref)
+                    return write(s);
+                // room for what is copied before s, s and what is copied after it
+                if(niov + 3 > max_iov)
+                    flush();
+                end_copied();
+                iov[niov++] = {const_cast<char*>(s.data()), s.size()};
+            }
+
+            void flush()
+            {
+                end_copied();
+                send();
+                n = copied = 0;
+            }
+
+        private:
+            // copying is cheaper than an iovec for short strings
+            static constexpr size_t min_ref = 128;
+#ifdef IOV_MAX
+            static constexpr int max_iov = IOV_MAX < 64 ? IOV_MAX : 64;
+#else
+            static constexpr int max_iov = 16;
+#endif
+
+            // writes the iovecs, buf may only be reused once everything is written
+            void send()
+            {
+                iovec* v = iov;
+                int left = niov;
+                while(left > 0)
+                {
+                    auto r = ::writev(fd, v, left);
+                    if(r < 0 && errno == EINTR)
+                        continue;
+                    if(r <= 0)
+                        break;
+                    auto k = static_cast<size_t>(r);
+                    for(; left > 0 && k >= v->iov_len; v++, left--)
+                        k -= v->iov_len;
+                    if(left > 0)
+                    {
+                        v->iov_base = static_cast<char*>(v->iov_base) + k;
+                        v->iov_len -= k;
+                    }
+                }
+                niov = 0;
+            }
+
+            // adds what was copied into buf since the last iovec as an iovec
+            void end_copied()
+            {
+                if(n > copied)
+                {
+                    if(niov == max_iov)
+                        send();
+                    iov[niov++] = {buf + copied, n - copied};
+                }
+                copied = n;
+            }
+
+            int fd;
+            char buf[4096];
+            size_t n = 0;
+            size_t copied = 0;
+            iovec iov[max_iov];
+            int niov = 0;
+        };
+#endif // EZPRINT_ENABLE_POSIX
+
+#if EZPRINT_ENABLE_STATS
+        // name of T as the compiler spells it
+        template <typename T>
+        inline std::string_view type_name()
+        {
+#if defined(__clang__) || defined(__GNUC__)
+            std::string_view s = __PRETTY_FUNCTION__;
+            auto first = s.find("T = ");
+            if(first == s.npos)
+                return "?";
+            first += 4;
+            auto last = s.find(';', first);
+            if(last == s.npos)
+                last = s.rfind(']');
+            return s.substr(first, last - first);
+#elif defined(_MSC_VER)
+            std::string_view s = __FUNCSIG__;
+            auto first = s.find("type_name<");
+            auto last = s.rfind(">(void)");
+            if(first == s.npos || last == s.npos)
+                return "?";
+            first += 10;
+            return s.substr(first, last - first);
+#else
+            return "?";
+#endif
+        }
+
+        struct stats_totals
+        {
+            std::uint64_t calls = 0;
+            std::uint64_t bytes = 0;
+            std::uint64_t elements = 0;
+            std::uint64_t nanoseconds = 0;
+        };
+
+        class thread_stats;
+
+        // what stats are kept for, which are the argument types of a call or its call site,
+        // numbered in order of first use, and the threads keeping them
+        struct stats_registry
+        {
+            std::mutex mutex;
+            std::vector<std::string> names;
+            std::vector<bool> sites;
+            std::unordered_map<std::string, size_t> site_ids;
+            std::vector<thread_stats*> threads;
+            // totals of the threads that have exited
+            std::vector<stats_totals> retired;
+
+            size_t add_key(std::string name, bool site)
+            {
+                std::lock_guard lock(mutex);
+                if(site)
+                {
+                    auto [it, added] = site_ids.try_emplace(name, names.size());
+                    if(!added)
+                        return it->second;
+                }
+                names.push_back(std::move(name));
+                sites.push_back(site);
+                return names.size() - 1;
+            }
+        };
+
+        inline stats_registry& global_stats()
+        {
+            static stats_registry r;
+            return r;
+        }
+
+        // counters of one thread, in chunks that never move once allocated
+        // only the owning thread writes them, other threads read them without locking
+        class thread_stats
+        {
+        public:
+            static constexpr size_t chunk = 64;
+            static constexpr size_t max_chunks = 256;
+
+            thread_stats() : reg(global_stats())
+            {
+                std::lock_guard lock(reg.mutex);
+                reg.threads.push_back(this);
+            }
+            thread_stats(const thread_stats&) = delete;
+            thread_stats& operator=(const thread_stats&) = delete;
+
+            ~thread_stats()
+            {
+                std::lock_guard lock(reg.mutex);
+                collect(reg.retired);
+                reg.threads.erase(std::find(reg.threads.begin(), reg.threads.end(), this));
+                for(auto& c : chunks)
+                    delete[] c.load(std::memory_order_relaxed);
+            }
+
+            // keys past the last chunk aren't counted
+            void add(size_t key, const stats_totals& t)
+            {
+                if(key >= chunk * max_chunks)
+                    return;
+                auto& c = chunks[key / chunk];
+                auto p = c.load(std::memory_order_relaxed);
+                if(!p)
+                {
+                    p = new stats_cell[chunk];
+                    c.store(p, std::memory_order_release);
+                }
+                auto& cell = p[key % chunk];
+                bump(cell.calls, t.calls);
+                bump(cell.bytes, t.bytes);
+                bump(cell.elements, t.elements);
+                bump(cell.nanoseconds, t.nanoseconds);
+            }
+
+            // adds the counters to totals, indexed by key
+            void collect(std::vector<stats_totals>& totals) const
+            {
+                for(size_t i = 0; i < max_chunks; i++)
+                {
+                    auto p = chunks[i].load(std::memory_order_acquire);
+                    if(!p)
+                        continue;
+                    if(totals.size() < (i + 1) * chunk)
+                        totals.resize((i + 1) * chunk);
+                    for(size_t j = 0; j < chunk; j++)
+                    {
+                        auto& t = totals[i * chunk + j];
+                        t.calls += p[j].calls.load(std::memory_order_relaxed);
+                        t.bytes += p[j].bytes.load(std::memory_order_relaxed);
+                        t.elements += p[j].elements.load(std::memory_order_relaxed);
+                        t.nanoseconds += p[j].nanoseconds.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+#if __cpp_lib_source_location >= 201907L
+            // key of a call site, looked up by the thread before asking the registry
+            size_t site_key(const std::source_location& loc)
+            {
+                site s{loc.file_name(), loc.line(), loc.column()};
+                auto it = site_keys.find(s);
+                if(it != site_keys.end())
+                    return it->second;
+
+                std::string name = loc.file_name();
+                name += ':';
+                name += std::to_string(loc.line());
+                name += ':';
+                name += std::to_string(loc.column());
+                name += ' ';
+                name += loc.function_name();
+                return site_keys[s] = reg.add_key(std::move(name), true);
+            }
+#endif // __cpp_lib_source_location >= 201907L
+
+        private:
+            struct stats_cell
+            {
+                std::atomic<std::uint64_t> calls{0};
+                std::atomic<std::uint64_t> bytes{0};
+                std::atomic<std::uint64_t> elements{0};
+                std::atomic<std::uint64_t> nanoseconds{0};
+            };
+
+            // a plain store, there are no other writers
+            static void bump(std::atomic<std::uint64_t>& a, std::uint64_t n)
+            {
+                a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+            }
+
+            struct site
+            {
+                const char* file;
+                std::uint_least32_t line;
+                std::uint_least32_t column;
+
+                bool operator==(const site& s) const
+                {
+                    return file == s.file && line == s.line && column == s.column;
+                }
+            };
+
+            struct site_hash
+            {
+                size_t operator()(const site& s) const
+                {
+                    return std::hash<const void*>()(s.file) ^ (size_t(s.line) << 16) ^ s.column;
+                }
+            };
+
+            stats_registry& reg;
+            std::atomic<stats_cell*> chunks[max_chunks] = {};
+            std::unordered_map<site, size_t, site_hash> site_keys;
+        };
+
+        // constructed before first use, after global_stats, so that it is destroyed before it
+        inline thread_stats& this_thread_stats()
+        {
+            thread_local thread_stats t;
+            return t;
+        }
+
+        // leaves printed on this thread by writers that aren't only measuring
+        inline std::uint64_t& stats_elements()
+        {
+            thread_local std::uint64_t n = 0;
+            return n;
+        }
+
+        // key of the argument types Ts
+        template <typename... Ts>
+        inline size_t types_key()
+        {
+            static const size_t key = [] {
+                std::string name;
+                ((name += name.empty() ? "" : ", ", name += type_name<Ts>()), ...);
+                return global_stats().add_key(std::move(name), false);
+            }();
+            return key;
+        }
+
+        // output iterator forwarding to out and counting the characters into *n
+        template <typename It>
+        struct tally_iterator
+        {
+            using iterator_category = std::output_iterator_tag;
+            using value_type = void;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = void;
+
+            tally_iterator& operator*() { return *this; }
+            tally_iterator& operator=(char c)
+            {
+                *out = c;
+                ++out;
+                ++*n;
+                return *this;
+            }
+            tally_iterator& operator++() { return *this; }
+            tally_iterator operator++(int) { return *this; }
+
+            template <typename I = It, typename = ref_write_t<I>>
+            void write_ref(std::string_view s)
+            {
+                out.write_ref(s);
+                *n += s.size();
+            }
+
+            It out;
+            std::uint64_t* n;
+        };
+
+        template <typename It>
+        inline tally_iterator<It> copy_chars(std::string_view s, tally_iterator<It> out)
+        {
+            out.out = copy_chars(s, out.out);
+            *out.n += s.size();
+            return out;
+        }
+
+        template <typename Fmt>
+        using location_t = decltype(std::declval<const Fmt&>().loc);
+
+        // records a call of an entry point printing Ts when destroyed, with its duration, the
+        // leaves printed meanwhile and the bytes that went through wrap or add_bytes
+        template <typename... Ts>
+        class stats_scope
+        {
+        public:
+            stats_scope() = default;
+
+            // also counts the call for the call site of fmt, if it knows its location
+            template <typename Fmt>
+            explicit stats_scope(const Fmt& fmt)
+            {
+#if __cpp_lib_source_location >= 201907L
+                if constexpr(std::experimental::is_detected_v<location_t, Fmt>)
+                    site = this_thread_stats().site_key(fmt.loc);
+#endif // __cpp_lib_source_location >= 201907L
+            }
+            stats_scope(const stats_scope&) = delete;
+            stats_scope& operator=(const stats_scope&) = delete;
+
+            ~stats_scope()
+            {
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start);
+                stats_totals t{1, bytes, stats_elements() - elements,
+                               static_cast<std::uint64_t>(ns.count())};
+                auto& stats = this_thread_stats();
+                stats.add(types_key<std::decay_t<Ts>...>(), t);
+                if(site != SIZE_MAX)
+                    stats.add(site, t);
+            }
+
+            template <typename It>
+            tally_iterator<It> wrap(It out)
+            {
+                return {out, &bytes};
+            }
+
+            template <typename It>
+            It unwrap(tally_iterator<It> out)
+            {
+                return out.out;
+            }
+
+            // leaves are printed into an ostream of the writer's own, whose output is counted
+            const std::ios& like(std::ostream& os) { return os; }
+
+            void add_bytes(size_t n) { bytes += n; }
+
+        private:
+            size_t site = SIZE_MAX;
+            std::uint64_t bytes = 0;
+            std::uint64_t elements = stats_elements();
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        };
+#else
+        // does nothing, stats are only kept with EZPRINT_STATS
+        template <typename... Ts>
+        struct stats_scope
+        {
+            stats_scope() = default;
+            template <typename Fmt>
+            explicit stats_scope(const Fmt&)
+            {
+            }
+
+            template <typename It>
+            It wrap(It out)
+            {
+                return out;
+            }
+
+            template <typename It>
+            It unwrap(It out)
+            {
+                return out;
+            }
+
+            std::ostream& like(std::ostream& os) { return os; }
+
+            void add_bytes(size_t) {}
+        };
+#endif // EZPRINT_ENABLE_STATS
+
+        // writer is what the traversal in fprint outputs to
+        // put and write receive the punctuation, leaf receives streamable values
+        // leaves only go through an ostream when there is no faster way to write them,
+        // that ostream is either the one supplied by the caller or created on first use,
+        // optionally with the same formatting as like
+        template <typename It>
+        class writer
+        {
+        public:
+            explicit writer(It out) : it(out) {}
+            // for a second pass over the same values, which doesn't look at the locale again
+            writer(It out, std::optional<bool> classic) : it(out), classic(classic) {}
+            // the width of the stream applies to what is written first, as with operator<<
+            writer(It out, std::ostream& os) : it(out), os(&os), width(os.width()) {}
+            writer(It out, const std::ios& like) : it(out), like(&like), width(like.width()) {}
+            writer(const writer&) = delete;
+            writer& operator=(const writer&) = delete;
+#if EZPRINT_ENABLE_STATS
+            ~writer()
+            {
+                if constexpr(!std::is_same_v<It, counting_iterator> &&
+                             !std::is_same_v<It, ascii_counting_iterator>)
+                    stats_elements() += elements;
+            }
+#endif // EZPRINT_ENABLE_STATS
+
+            void put(char c)
+            {
+                if(width != 0)
+                    return write_padded({&c, 1});
+                *it = c;
+                ++it;
+            }
+
+            void write(std::string_view s)
+            {
+                if(width != 0)
+                    return write_padded(s);
+                it = copy_chars(s, it);
+            }
+
+            template <typename T>
+            void leaf(T&& t)
+            {
+                using rT = std::remove_cv_t<std::remove_reference_t<T>>;
+#if EZPRINT_ENABLE_STATS
+                elements++;
+#endif // EZPRINT_ENABLE_STATS
+                if constexpr(std::is_same_v<rT, char>)
+                    put(t);
+                else if constexpr(std::is_same_v<rT, std::string> ||
+                                  std::is_same_v<rT, std::string_view>)
+                    write_leaf(t);
+                else if constexpr(is_number_v<rT>)
+                {
+                    if(plain_numbers())
+                        number(t);
+                    else
+                        stream() << t;
+                }
+                else if constexpr(is_char_ptr_v<T> && std::is_array_v<rT>)
+                    write_leaf(t);
+                else if constexpr(is_char_ptr_v<T>)
+                {
+                    if(t)
+                        write_leaf(t);
+                    else
+                        stream() << t;
+                }
+                else
+                    stream() << t;
+            }
+
+            template <typename T>
+            void number(T n)
+            {
+                if constexpr(std::is_same_v<It, counting_iterator>)
+                    it.n += count_number(n);
+                else
+                {
+                    char buf[max_number_chars];
+                    write({buf, static_cast<size_t>(write_number(buf, n) - buf)});
+                }
+            }
+
+            // writes the contiguous numbers separated by spaces, in batches through one buffer
+            template <typename T>
+            void numbers(const T* p, size_t n)
+            {
+#if EZPRINT_ENABLE_STATS
+                elements += n;
+#endif // EZPRINT_ENABLE_STATS
+                if constexpr(std::is_same_v<It, counting_iterator>)
+                {
+                    for(size_t i = 0; i < n; i++)
+                        it.n += count_number(p[i]);
+                    it.n += n > 0 ? n - 1 : 0;
+                    return;
+                }
+
+                char buf[4096];
+                char* last = buf;
+                for(size_t i = 0; i < n; i++)
+                {
+                    if(buf + sizeof(buf) - last <= static_cast<std::ptrdiff_t>(max_number_chars))
+                    {
+                        write({buf, static_cast<size_t>(last - buf)});
+                        last = buf;
+                    }
+                    if(i > 0)
+                        *last++ = ' ';
+                    last = write_number(last, p[i]);
+                }
+                write({buf, static_cast<size_t>(last - buf)});
+            }
+
+            // limits, which are only imposed by limited_writer
+            static constexpr bool limited = false;
+            static constexpr size_t max_elements() { return SIZE_MAX; }
+            static constexpr bool too_deep() { return false; }
+            static constexpr void enter() {}
+            static constexpr void leave() {}
+            static constexpr bool stopped() { return false; }
+
+            // leaves within temporaries are always copied, they die before the output is flushed
+            void enter_temporary() { temporaries++; }
+            void leave_temporary() { temporaries--; }
+
+            // numbers are only written with to_chars when the output is byte identical
+            bool plain_numbers() const
+            {
+                auto fmt = os ? static_cast<const std::ios*>(os) : like;
+                return width == 0 && (!fmt || is_plain_numeric(*fmt)) && classic_numbers();
+            }
+
+            // whether the locale prints numbers as the classic one, unknown until the first number
+            std::optional<bool> numeric_locale() const { return classic; }
+
+            It out() const { return it; }
+
+            void advance_to(It out) { it = out; }
+
+#if EZPRINT_ENABLE_STATS
+            // for leaves a derived writer prints without leaf
+            void count_leaf() { elements++; }
+#endif // EZPRINT_ENABLE_STATS
+
+        private:
+            // the locale is only looked at for the first number, much output has none
+            // the stream of the caller keeps the result, own has the locale of like or the global one
+            bool classic_numbers() const
+            {
+                if(!classic)
+                {
+                    if(os && !own)
+                        classic = is_classic_numeric(*os);
+                    else if(like)
+                        // like is only const to the writer, which keeps no more than that word in it
+                        classic = is_classic_numeric(const_cast<std::ios&>(*like));
+                    else
+                        classic = is_classic_numeric(std::locale());
+                }
+                return *classic;
+            }
+
+            // strings that outlive the writer may be written by reference when It supports it
+            void write_leaf(std::string_view s)
+            {
+                if constexpr(std::experimental::is_detected_v<ref_write_t, It>)
+                    if(temporaries == 0 && width == 0)
+                        return it.write_ref(s);
+                write(s);
+            }
+
+            // pads s with the fill of the stream on the side its adjustfield says
+            void write_padded(std::string_view s)
+            {
+                auto fmt = os ? static_cast<const std::ios*>(os) : like;
+                auto pad = static_cast<size_t>(width) > s.size() ? static_cast<size_t>(width) - s.size() : 0;
+                bool left = (fmt->flags() & std::ios_base::adjustfield) == std::ios_base::left;
+                width = 0;
+                if(!left)
+                    fill(fmt->fill(), pad);
+                write(s);
+                if(left)
+                    fill(fmt->fill(), pad);
+            }
+
+            void fill(char c, size_t n)
+            {
+                for(size_t i = 0; i < n; i++)
+                    put(c);
+            }
+
+            // the stream leaves are printed to when there is no faster way,
+            // with the width if nothing was written yet
+            std::ostream& stream()
+            {
+                if(!os)
+                {
+                    os = &own.emplace(&buf);
+                    if(like)
+                        own->copyfmt(*like);
+                }
+                if(width != 0)
+                {
+                    os->width(width);
+                    width = 0;
+                }
+                return *os;
+            }
+
+            It it;
+            std::ostream* os = nullptr;
+            const std::ios* like = nullptr;
+            mutable std::optional<bool> classic;
+            std::streamsize width = 0;
+            size_t temporaries = 0;
+#if EZPRINT_ENABLE_STATS
+            std::uint64_t elements = 0;
+#endif // EZPRINT_ENABLE_STATS
+            iterator_streambuf<It> buf{it};
+            std::optional<std::ostream> own;
+        };
+
+        // marks a nesting level of the traversal for limits
+        template <typename W>
+        struct nested
+        {
+            explicit nested(W& w) : w(w) { w.enter(); }
+            ~nested() { w.leave(); }
+            W& w;
+        };
+
+        // marks what is printed meanwhile as temporaries when value is true
+        template <typename W, bool value>
+        struct temporary
+        {
+            explicit temporary(W& w) : w(w)
+            {
+                if constexpr(value)
+                    w.enter_temporary();
+            }
+            ~temporary()
+            {
+                if constexpr(value)
+                    w.leave_temporary();
+            }
+            W& w;
+        };
+
+        // the elements of a range are temporaries when dereferencing its iterators
+        // doesn't return a lvalue reference
+        template <typename W, typename T>
+        using temporary_elements =
+            temporary<W, !std::is_lvalue_reference_v<decltype(*std::declval<begin_t<T>&>())>>;
+
+        // marks the elements of t from the i-th on as elided
+        template <typename W, typename T>
+        inline void elide(W& w, T& t, size_t i)
+        {
+            w.write("...");
+            if constexpr(std::experimental::is_detected_v<container_size_t, T&>)
+            {
+                w.write(" (+");
+                w.number(static_cast<size_t>(std::size(t)) - i);
+                w.put(')');
+            }
+        }
+
+        // how fprint prints T
+        enum class shape
+        {
+            leaf,
+            range,
+            tuple,
+            aggregate,
+            unknown,
+        };
+
+        template <typename T>
+        inline constexpr shape shape_of()
+        {
+            using rT = std::remove_reference_t<T>;
+
+            // order of if is important, the desired behaviour is to supply alternative
+            // printing formats only when the most natural isn't available
+            if constexpr(std::experimental::is_detected_v<stream_t, T> && (!std::is_array_v<rT> || is_string_v<rT>))
+                return shape::leaf;
+            else if constexpr(std::experimental::is_detected_v<begin_t, T> &&
+                              std::experimental::is_detected_v<end_t, T>)
+                return shape::range;
+            else if constexpr(std::experimental::is_detected_v<tuple_size_t, rT>)
+                return shape::tuple;
+            else if constexpr(std::is_aggregate_v<rT>)
+                return shape::aggregate;
+            else
+                return shape::unknown;
+        }
+
+        template <typename T>
+        using fields_t = decltype(as_tuple(std::declval<T&>(), count_t<std::remove_reference_t<T>>{}));
+
+        // the type of get<I>(t) for a lvalue t of type T, without resolving the overloads of get
+        template <size_t I, typename T>
+        using element_ref_t = std::add_lvalue_reference_t<std::tuple_element_t<I, T>>;
+
+        // the text between the leaves and ranges of a tuple or aggregate, which are called slots
+        // built at compile time, into text when it isn't null, otherwise only counted
+        struct skeleton_builder
+        {
+            char* text;
+            size_t* ends;
+            size_t n = 0;
+            size_t slots = 0;
+
+            constexpr void append(std::string_view s)
+            {
+                for(char c : s)
+                {
+                    if(text)
+                        text[n] = c;
+                    n++;
+                }
+            }
+
+            // ends the literal before a slot
+            constexpr void slot()
+            {
+                if(ends)
+                    ends[slots] = n;
+                slots++;
+            }
+
+            template <typename T>
+            constexpr void build()
+            {
+                constexpr auto sh = shape_of<T>();
+                if constexpr(sh == shape::leaf || sh == shape::range)
+                    slot();
+                else if constexpr(sh == shape::tuple)
+                {
+                    using rT = std::remove_reference_t<T>;
+                    constexpr auto len = std::tuple_size_v<rT>;
+                    if constexpr(len > 0)
+                        index_upto<len>([&](auto, auto... is) {
+                            append("{");
+                            build<element_ref_t<0, rT>>();
+                            ((append(" "), build<element_ref_t<decltype(is){}, rT>>()), ...);
+                            append("}");
+                        });
+                    else
+                        append("{}");
+                }
+                else if constexpr(sh == shape::aggregate)
+                    build<fields_t<T>>();
+                else
+                    append("!(UNKNOWN TYPE)");
+            }
+        };
+
+        template <typename T>
+        struct skeleton
+        {
+            static constexpr auto size = [] {
+                skeleton_builder b{nullptr, nullptr};
+                b.build<T>();
+                return b;
+            }();
+
+            // literal i is text[ends[i - 1], ends[i])
+            struct data_t
+            {
+                char text[size.n + 1];
+                size_t ends[size.slots + 1];
+            };
+            static constexpr data_t data = [] {
+                data_t d{};
+                skeleton_builder b{d.text, d.ends};
+                b.build<T>();
+                d.ends[b.slots] = b.n;
+                return d;
+            }();
+
+            static constexpr std::string_view literal(size_t i)
+            {
+                size_t first = i > 0 ? data.ends[i - 1] : 0;
+                return {data.text + first, data.ends[i] - first};
+            }
+        };
+
+        template <typename T>
+        inline constexpr bool is_composite_v = shape_of<T>() == shape::tuple || shape_of<T>() == shape::aggregate;
+
+        template <typename T, typename Is = std::make_index_sequence<std::tuple_size_v<T>>>
+        inline constexpr bool has_composite_element_v = false;
+        template <typename T, size_t... Is>
+        inline constexpr bool has_composite_element_v<T, std::index_sequence<Is...>> =
+            (is_composite_v<element_ref_t<Is, T>> || ...);
+
+        // whether printing T with its skeleton saves writes, which takes a tuple or aggregate
+        // nested in T, otherwise every literal is a single character
+        // decided from the element types, since building the skeleton of every flat tuple and
+        // aggregate printed costs more compile time than it saves at run time
+        template <typename T>
+        inline constexpr bool use_skeleton()
+        {
+            using rT = std::remove_reference_t<T>;
+            constexpr auto sh = shape_of<T>();
+            if constexpr(sh == shape::tuple)
+                return has_composite_element_v<rT>;
+            else if constexpr(sh == shape::aggregate)
+                return has_composite_element_v<std::remove_reference_t<fields_t<T>>>;
+            else
+                return false;
+        }
+
+        // calls f(slot, index, temporary) on the slots of t in order, index is an integral
+        // constant counting from I, temporary tells if the slot is within an element that get
+        // returned by value
+        template <size_t I, bool Temporary = false, typename T, typename F>
+        inline void visit_slots(T&& t, F& f)
+        {
+            using rT = std::remove_reference_t<T>;
+            constexpr auto sh = shape_of<T>();
+            if constexpr(sh == shape::leaf || sh == shape::range)
+                f(t, std::integral_constant<size_t, I>{}, std::bool_constant<Temporary>{});
+            else if constexpr(sh == shape::tuple)
+            {
+                // empty tuples have no slots
+                if constexpr(std::tuple_size_v<rT> > 0)
+                    index_upto<std::tuple_size_v<rT>>([&](auto... is) {
+                        // index of the first slot of each element
+                        constexpr auto first = [] {
+                            std::array<size_t, sizeof...(is) + 1> a{I};
+                            size_t j = 0;
+                            ((a[j + 1] = a[j] + skeleton<element_ref_t<decltype(is){}, rT>>::size.slots, j++), ...);
+                            return a;
+                        }();
+                        (visit_slots<first[decltype(is){}],
+                                     Temporary || !std::is_lvalue_reference_v<decltype(get<decltype(is){}>(t))>>(
+                             get<decltype(is){}>(t), f),
+                         ...);
+                    });
+            }
+            else if constexpr(sh == shape::aggregate)
+                visit_slots<I, Temporary>(as_tuple(t, count_t<rT>{}), f);
+        }
+
+        template <typename W, typename T>
+        inline void fprint(W& w, T&& t);
+
+        // prints an element of a tuple, which is a temporary when get returns it by value
+        template <typename W, typename T>
+        inline void fprint_element(W& w, T&& t)
+        {
+            temporary<W, !std::is_lvalue_reference_v<T>> element(w);
+            fprint(w, t);
+        }
+
+        // prints a tuple or aggregate with each run of punctuation between its slots in one write
+        // bypasses the nesting checks, so only for writers without limits
+        template <typename W, typename T>
+        inline void fprint_skeleton(W& w, T& t)
+        {
+            using S = skeleton<T&>;
+            auto write = [&](auto i) {
+                constexpr auto s = S::literal(decltype(i)::value);
+                if constexpr(s.size() == 1)
+                    w.put(s[0]);
+                else if constexpr(s.size() > 1)
+                    w.write(s);
+            };
+            auto slot = [&](auto& x, auto i, auto temporary_slot) {
+                temporary<W, decltype(temporary_slot)::value> element(w);
+                fprint(w, x);
+                write(std::integral_constant<size_t, decltype(i)::value + 1>{});
+            };
+            write(std::integral_constant<size_t, 0>{});
+            visit_slots<0>(t, slot);
+        }
+
+        template <typename W, typename T>
+        inline void fprint(W& w, T&& t)
+        {
+            // T is always a lvalue reference
+            using rT = std::remove_reference_t<T>;
+            constexpr auto sh = shape_of<T>();
+
+            if constexpr(!W::limited && use_skeleton<T&>())
+                fprint_skeleton(w, t);
+            else if constexpr(sh == shape::leaf)
+                w.leaf(t);
+            else if constexpr(sh == shape::range)
+            {
+                if(w.too_deep())
+                    return w.write("{...}");
+                nested level(w);
+
+                if constexpr(is_contiguous_numbers_v<T>)
+                    if(w.plain_numbers())
+                    {
+                        // in chunks, so that exceeding the byte limit stops early
+                        constexpr size_t chunk = 4096;
+                        size_t size = std::size(t);
+                        size_t n = std::min(size, w.max_elements());
+                        w.put('{');
+                        for(size_t i = 0; i < n && !w.stopped(); i += chunk)
+                        {
+                            if(i > 0)
+                                w.put(' ');
+                            w.numbers(std::data(t) + i, std::min(chunk, n - i));
+                        }
+                        if(n < size)
+                        {
+                            if(n > 0)
+                                w.put(' ');
+                            elide(w, t, n);
+                        }
+                        w.put('}');
+                        return;
+                    }
+
+                temporary_elements<W, T> elements(w);
+                size_t i = 0;
+                w.put('{');
+                for(auto&& x : t)
+                {
+                    if(i > 0)
+                        w.put(' ');
+
+                    if(i == w.max_elements() || w.stopped())
+                    {
+                        elide(w, t, i);
+                        break;
+                    }
+
+                    // this is a somewhat special case, where the presence of mapped_type is
+                    // taken as being an associative container
+                    if constexpr(std::experimental::is_detected_v<mapped_type, rT>)
+                    {
+                        fprint(w, x.first);
+                        w.write(": ");
+                        fprint(w, x.second);
+                    }
+                    else
+                        fprint(w, x);
+
+                    i++;
+                }
+                w.put('}');
+            }
+            else if constexpr(sh == shape::tuple)
+            {
+                constexpr auto len = std::tuple_size_v<rT>;
+                if(len > 0 && w.too_deep())
+                    return w.write("{...}");
+                nested level(w);
+
+                if constexpr(len > 0)
+                    index_upto<len>([&](auto, auto... is) {
+                        w.put('{');
+                        fprint_element(w, get<0>(t));
+                        ((w.put(' '), fprint_element(w, get<decltype(is){}>(t))), ...);
+                        w.put('}');
+                    });
+                else
+                    w.write("{}");
+            }
+            else if constexpr(sh == shape::aggregate)
+                fprint(w, as_tuple(t, count_t<rT>{}));
+            else
+                w.write("!(UNKNOWN TYPE)");
+        }
+
+        template <typename W, typename T, typename... Ts>
+        inline void fprint(W& w, T&& t, Ts&&... ts)
+        {
+            fprint(w, t);
+            ((w.put(' '), fprint(w, ts)), ...);
+        }
+
+        template <typename W>
+        inline void fprint(W&) {}
+
+        // writer imposing limits, output past max_total_bytes is discarded by the iterator
+        template <typename It>
+        class limited_writer : public writer<truncating_iterator<It>>
+        {
+            using base = writer<truncating_iterator<It>>;
+
+        public:
+            limited_writer(It out, const limits& lim)
+                : base({out, lim.max_total_bytes}), lim(lim)
+            {
+            }
+            limited_writer(It out, const limits& lim, const std::ios& like)
+                : base({out, lim.max_total_bytes}, like), lim(lim)
+            {
+            }
+
+            static constexpr bool limited = true;
+            size_t max_elements() const { return lim.max_elements_per_range; }
+            bool too_deep() const { return depth >= lim.max_depth; }
+            void enter() { depth++; }
+            void leave() { depth--; }
+            bool stopped() const { return this->out().n > lim.max_total_bytes; }
+
+            // marks the cut output and returns the end of the output
+            It finish()
+            {
+                auto it = this->out();
+                if(it.n > lim.max_total_bytes)
+                    return copy_chars("...", it.out);
+                return it.out;
+            }
+
+        private:
+            limits lim;
+            size_t depth = 0;
+        };
+
+        inline long& limits_word(std::ios_base& os, int i)
+        {
+            static const int index[] = {std::ios_base::xalloc(), std::ios_base::xalloc(),
+                                        std::ios_base::xalloc()};
+            return os.iword(index[i]);
+        }
+
+        template <typename T>
+        using iterator_category_t =
+            typename std::iterator_traits<std::decay_t<begin_t<T>>>::iterator_category;
+
+        // ranges fprint can split into chunks, which are printed as ranges and have a size
+        // and random access iterators
+        template <typename T, typename = void>
+        inline constexpr bool is_parallel_range_v = false;
+        template <typename T>
+        inline constexpr bool is_parallel_range_v<T, std::enable_if_t<
+            std::experimental::is_detected_v<iterator_category_t, T> &&
+            std::experimental::is_detected_v<container_size_t, T>>> =
+            !std::experimental::is_detected_v<stream_t, T> && !std::is_array_v<std::remove_reference_t<T>> &&
+            std::experimental::is_detected_v<end_t, T> &&
+            !std::experimental::is_detected_v<mapped_type, std::remove_reference_t<T>> &&
+            std::is_base_of_v<std::random_access_iterator_tag, iterator_category_t<T>>;
+
+        // prints the elements in [first, last) separated by spaces
+        template <typename W, typename It>
+        inline void fprint_elements(W& w, It first, It last)
+        {
+            for(auto it = first; it != last; ++it)
+            {
+                if(it != first)
+                    w.put(' ');
+                fprint(w, *it);
+            }
+        }
+
+#if EZPRINT_ENABLE_THREADS
+        // prints the range t to os by rendering chunks of it on worker threads and writing
+        // the chunks to os in order as they are done, the output is the same as fprint's
+        // returns false without printing when t is too small to be worth splitting
+        template <typename T>
+        inline bool fprint_parallel(std::ostream& os, T& t)
+        {
+            constexpr size_t min_chunk = 1024;
+            size_t size = std::size(t);
+            size_t nthreads = std::max(1u, std::thread::hardware_concurrency());
+            size_t nchunks = std::min(nthreads * 4, (size + min_chunk - 1) / min_chunk);
+            if(nthreads == 1 || nchunks <= 1)
+                return false;
+
+            size_t chunk = (size + nchunks - 1) / nchunks;
+            nchunks = (size + chunk - 1) / chunk;
+
+            // chunks are handed over under the mutex, which is only held to move them
+            struct rendered
+            {
+                std::string text;
+                std::exception_ptr error;
+                bool done = false;
+            };
+            std::vector<rendered> chunks(nchunks);
+            // so that the workers only read the word of os that keeps it
+            is_classic_numeric(os);
+            std::mutex mutex;
+            std::condition_variable ready;
+
+            std::atomic<size_t> next{0};
+            auto render = [&] {
+                for(size_t c; (c = next++) < nchunks;)
+                {
+                    rendered r;
+                    try
+                    {
+                        writer w{std::back_inserter(r.text), static_cast<const std::ios&>(os)};
+                        fprint_elements(w, begin(t) + c * chunk,
+                                        begin(t) + std::min(size, (c + 1) * chunk));
+                    }
+                    catch(...)
+                    {
+                        r.error = std::current_exception();
+                    }
+                    r.done = true;
+                    {
+                        std::lock_guard lock(mutex);
+                        chunks[c] = std::move(r);
+                    }
+                    ready.notify_all();
+                }
+            };
+
+            // workers are stopped and joined even if writing to os throws
+            struct pool
+            {
+                std::atomic<size_t>& next;
+                size_t nchunks;
+                std::vector<std::thread> threads;
+                ~pool()
+                {
+                    next = nchunks;
+                    for(auto& t : threads)
+                        t.join();
+                }
+            } workers{next, nchunks, {}};
+            for(size_t i = 0; i < std::min(nthreads, nchunks); i++)
+                workers.threads.emplace_back(render);
+
+            std::ostream::sentry s(os);
+            if(!s)
+                return true;
+            os.put('{');
+            for(size_t c = 0; c < nchunks; c++)
+            {
+                rendered r;
+                {
+                    std::unique_lock lock(mutex);
+                    ready.wait(lock, [&] { return chunks[c].done; });
+                    r = std::move(chunks[c]);
+                }
+                if(r.error)
+                    std::rethrow_exception(r.error);
+                if(c > 0)
+                    os.put(' ');
+                os.write(r.text.data(), r.text.size());
+            }
+            os.put('}');
+            return true;
+        }
+#endif // EZPRINT_ENABLE_THREADS
+
+        inline bool is_limited(const limits& lim)
+        {
+            return lim.max_elements_per_range != SIZE_MAX || lim.max_depth != SIZE_MAX ||
+                   lim.max_total_bytes != SIZE_MAX;
+        }
+
+        // the width of os is taken by the writer printing to it, which applies it as operator<< does
+        // only written when set, so that threads sharing a stream without a width only read it
+        inline void reset_width(std::ios_base& os)
+        {
+            if(os.width() != 0)
+                os.width(0);
+        }
+
+#if EZPRINT_ENABLE_DIRECT_FORMAT
+        // pads s from first on to width with the fill of like, on the side its adjustfield
+        // says, as operator<< does for a string
+        inline void pad_to_width(std::string& s, size_t first, const std::ios& like,
+                                 std::streamsize width)
+        {
+            size_t size = s.size() - first;
+            if(width <= 0 || static_cast<size_t>(width) <= size)
+                return;
+            bool left = (like.flags() & std::ios_base::adjustfield) == std::ios_base::left;
+            s.insert(left ? s.size() : first, static_cast<size_t>(width) - size, like.fill());
+        }
+#endif // EZPRINT_ENABLE_DIRECT_FORMAT
+
+#if EZPRINT_ENABLE_THREADS
+        // one mutex per group of streambufs, so lines to unrelated streams rarely contend
+        inline std::mutex& stream_mutex(const void* buf)
+        {
+            static std::mutex mutexes[64];
+            return mutexes[reinterpret_cast<std::uintptr_t>(buf) / alignof(std::max_align_t) % 64];
+        }
+#endif // EZPRINT_ENABLE_THREADS
+
+    } // namespace detail
+
+#if EZPRINT_ENABLE_THREADS
+    // tag for printing each line with a single write that doesn't interleave with other
+    // lines printed with the tag, see fprintln
+    struct atomic_t
+    {
+        explicit atomic_t() = default;
+    };
+    inline constexpr atomic_t atomic{};
+
+    // tag for printing large random access ranges on several threads, see fprint
+    struct parallel_t
+    {
+        explicit parallel_t() = default;
+    };
+    inline constexpr parallel_t parallel{};
+#endif // EZPRINT_ENABLE_THREADS
+
+    template <typename OutputIt, typename... Ts>
+    inline detail::if_char_output_t<OutputIt, OutputIt> format_to(OutputIt out, Ts&&... ts)
+    {
+        detail::writer<OutputIt> w(out);
+        detail::fprint(w, std::forward<Ts>(ts)...);
+        return w.out();
+    }
+
+    template <typename OutputIt>
+    struct format_to_n_result
+    {
+        OutputIt out;
+        std::ptrdiff_t size;
+    };
+
+    // writes at most n characters, size is the length of the whole output
+    template <typename OutputIt, typename... Ts>
+    inline detail::if_char_output_t<OutputIt, format_to_n_result<OutputIt>>
+    format_to_n(OutputIt out, std::ptrdiff_t n, Ts&&... ts)
+    {
+        auto res = format_to(detail::truncating_iterator<OutputIt>(out, n > 0 ? n : 0),
+                             std::forward<Ts>(ts)...);
+        return {res.out, static_cast<std::ptrdiff_t>(res.n)};
+    }
+
+    // number of characters sprint would return
+    template <typename... Ts>
+    inline size_t formatted_size(Ts&&... ts)
+    {
+        return format_to(detail::counting_iterator{}, std::forward<Ts>(ts)...).n;
+    }
+
+    // limits of all printing to os without explicit limits
+    inline void set_limits(std::ios_base& os, const limits& lim)
+    {
+        // stored plus one, so that the zero of an unset word is no limit
+        detail::limits_word(os, 0) = static_cast<long>(lim.max_elements_per_range + 1);
+        detail::limits_word(os, 1) = static_cast<long>(lim.max_depth + 1);
+        detail::limits_word(os, 2) = static_cast<long>(lim.max_total_bytes + 1);
+    }
+
+    inline limits get_limits(std::ios_base& os)
+    {
+        return {static_cast<size_t>(detail::limits_word(os, 0)) - 1,
+                static_cast<size_t>(detail::limits_word(os, 1)) - 1,
+                static_cast<size_t>(detail::limits_word(os, 2)) - 1};
+    }
+
+    template <typename... Ts>
+    inline void fprint(limits lim, std::ostream& os, Ts&&... ts)
+    {
+        std::ostream::sentry s(os);
+        if(!s)
+            return;
+
+        detail::stats_scope<Ts...> stats;
+        detail::limited_writer w{stats.wrap(std::ostreambuf_iterator<char>(os)), lim,
+                                 static_cast<const std::ios&>(os)};
+        detail::reset_width(os);
+        detail::fprint(w, std::forward<Ts>(ts)...);
+        if(stats.unwrap(w.finish()).failed())
+            os.setstate(std::ios_base::badbit);
+    }
+
+    template <typename... Ts>
+    inline void fprint(std::ostream& os, Ts&&... ts)
+    {
+        auto lim = get_limits(os);
+        if(detail::is_limited(lim))
+            return fprint(lim, os, std::forward<Ts>(ts)...);
+
+        std::ostream::sentry s(os);
+        if(!s)
+            return;
+
+        detail::stats_scope<Ts...> stats;
+        detail::writer w{stats.wrap(std::ostreambuf_iterator<char>(os)), stats.like(os)};
+        detail::reset_width(os);
+        detail::fprint(w, std::forward<Ts>(ts)...);
+        if(stats.unwrap(w.out()).failed())
+            os.setstate(std::ios_base::badbit);
+    }
+
+#if EZPRINT_ENABLE_THREADS
+    // same as fprint, except sized random access ranges among ts are printed by several threads
+    // only worth it for ranges of many elements
+    template <typename... Ts>
+    inline void fprint(parallel_t, std::ostream& os, Ts&&... ts)
+    {
+        // chunks are printed without limits and formatted like os, width included
+        if(detail::is_limited(get_limits(os)) || os.width() != 0)
+            return fprint(os, std::forward<Ts>(ts)...);
+
+        int i = 0;
+        auto print_one = [&](auto& t) {
+            if(i++ > 0)
+                os << ' ';
+            if constexpr(detail::is_parallel_range_v<decltype(t)>)
+                if(detail::fprint_parallel(os, t))
+                    return;
+            fprint(os, t);
+        };
+        (print_one(ts), ...);
+    }
+
+    template <typename... Ts>
+    inline void fprintln(parallel_t, std::ostream& os, Ts&&... ts)
+    {
+        fprint(parallel, os, std::forward<Ts>(ts)...);
+        os << '\n';
+    }
+#endif // EZPRINT_ENABLE_THREADS
+
+    template <typename... Ts>
+    inline void fprintln(std::ostream& os, Ts&&... ts)
+    {
+        fprint(os, std::forward<Ts>(ts)...);
+        os << '\n';
+    }
+
+    template <typename... Ts>
+    inline void fprintln(limits lim, std::ostream& os, Ts&&... ts)
+    {
+        fprint(lim, os, std::forward<Ts>(ts)...);
+        os << '\n';
+    }
+
+#if EZPRINT_ENABLE_THREADS
+    // renders the line into a buffer of the calling thread, formatted like os,
+    // and writes it to os while holding a lock only for the write itself
+    template <typename... Ts>
+    inline void fprintln(atomic_t, std::ostream& os, Ts&&... ts)
+    {
+        // moved out and back in, so that printing from within operator<< is still fine
+        thread_local std::string buffer;
+        auto line = std::move(buffer);
+        line.clear();
+        detail::stats_scope<Ts...> stats;
+
+        if(auto lim = get_limits(os); detail::is_limited(lim))
+        {
+            detail::limited_writer w{std::back_inserter(line), lim, static_cast<const std::ios&>(os)};
+            detail::reset_width(os);
+            detail::fprint(w, ts...);
+            w.finish();
+        }
+        else
+        {
+            detail::writer w{std::back_inserter(line), static_cast<const std::ios&>(os)};
+            detail::reset_width(os);
+            detail::fprint(w, ts...);
+        }
+        line += '\n';
+        stats.add_bytes(line.size());
+
+        {
+            std::lock_guard lock(detail::stream_mutex(os.rdbuf()));
+            os.write(line.data(), line.size());
+        }
+        buffer = std::move(line);
+    }
+#endif // EZPRINT_ENABLE_THREADS
+
+    template <typename... Ts>
+    inline void print(Ts&&... ts)
+    {
+        fprint(std::cout, std::forward<Ts>(ts)...);
+    }
+
+    template <typename... Ts>
+    inline void println(Ts&&... ts)
+    {
+        fprint(std::cout, std::forward<Ts>(ts)...);
+        std::cout << '\n';
+    }
+
+#if EZPRINT_ENABLE_THREADS
+    template <typename... Ts>
+    inline void println(atomic_t, Ts&&... ts)
+    {
+        fprintln(atomic, std::cout, std::forward<Ts>(ts)...);
+    }
+#endif // EZPRINT_ENABLE_THREADS
+
+    template <typename... Ts>
+    inline void print(limits lim, Ts&&... ts)
+    {
+        fprint(lim, std::cout, std::forward<Ts>(ts)...);
+    }
+
+    template <typename... Ts>
+    inline void println(limits lim, Ts&&... ts)
+    {
+        fprintln(lim, std::cout, std::forward<Ts>(ts)...);
+    }
+
+#if EZPRINT_ENABLE_POSIX
+    // prints to the file descriptor fd with writev, long strings are written without copying
+    template <typename... Ts>
+    inline void dprint(int fd, Ts&&... ts)
+    {
+        detail::stats_scope<Ts...> stats;
+        detail::gather_buffer buf(fd);
+        detail::writer w{stats.wrap(buf.begin())};
+        detail::fprint(w, std::forward<Ts>(ts)...);
+    }
+
+    template <typename... Ts>
+    inline void dprintln(int fd, Ts&&... ts)
+    {
+        detail::stats_scope<Ts...> stats;
+        detail::gather_buffer buf(fd);
+        detail::writer w{stats.wrap(buf.begin())};
+        detail::fprint(w, std::forward<Ts>(ts)...);
+        w.put('\n');
+    }
+
+    struct mmap_options
+    {
+        // bytes the file grows by at a time, rounded up to whole pages
+        size_t extent = size_t(64) << 20;
+        // bytes the file is sized to up front
+        size_t reserve = 0;
+        // continues after what the file already holds instead of emptying it
+        bool append = false;
+        // tells the kernel the pages are written in order
+        bool sequential = true;
+    };
+
+    // output file printed into through memory mapped pages, grown an extent at a time
+    // the file is cut to the size of what was printed when closed
+    // output is discarded after an error, which good tells
+    class mmap_sink
+    {
+    public:
+        explicit mmap_sink(const char* path, const mmap_options& opt = {})
+            : sequential(opt.sequential)
+        {
+            auto page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            extent = (std::max(opt.extent, page) + page - 1) / page * page;
+            used = extent;
+
+            fd = ::open(path, O_RDWR | O_CREAT | (opt.append ? 0 : O_TRUNC), 0666);
+            struct stat st;
+            if(fd < 0 || ::fstat(fd, &st) < 0)
+            {
+                fail();
+                return;
+            }
+            file_size = static_cast<size_t>(st.st_size);
+            size_t end = opt.append ? file_size : 0;
+            offset = end;
+            if(opt.reserve > file_size && !grow(opt.reserve))
+            {
+                fail();
+                return;
+            }
+
+            // the window starts at the page the output continues in
+            offset = end / page * page;
+            if(!map_window())
+            {
+                offset = end;
+                fail();
+                return;
+            }
+            used = end - offset;
+        }
+
+        mmap_sink(const mmap_sink&) = delete;
+        mmap_sink& operator=(const mmap_sink&) = delete;
+        ~mmap_sink() { close(); }
+
+        class iterator
+        {
+        public:
+            using iterator_category = std::output_iterator_tag;
+            using value_type = void;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = void;
+
+            explicit iterator(mmap_sink& s) : s(&s) {}
+
+            iterator& operator*() { return *this; }
+            iterator& operator=(char c)
+            {
+                s->put(c);
+                return *this;
+            }
+            iterator& operator++() { return *this; }
+            iterator operator++(int) { return *this; }
+
+            void write(std::string_view str) { s->write(str); }
+
+        private:
+            mmap_sink* s;
+        };
+
+        iterator begin() { return iterator(*this); }
+
+        void put(char c)
+        {
+            if(used == extent && !next_window())
+                return;
+            map[used++] = c;
+        }
+
+        void write(std::string_view s)
+        {
+            while(!s.empty())
+            {
+                if(used == extent && !next_window())
+                    return;
+                size_t n = std::min(s.size(), extent - used);
+                std::memcpy(map + used, s.data(), n);
+                used += n;
+                s.remove_prefix(n);
+            }
+        }
+
+        // bytes in the file, including what it held before when appending
+        size_t size() const { return map ? offset + used : offset; }
+
+        bool good() const { return !failed; }
+
+        // unmaps the pages and cuts the file to size
+        void close()
+        {
+            if(fd < 0)
+                return;
+            offset = size();
+            if(map && ::munmap(map, extent) < 0)
+                failed = true;
+            map = nullptr;
+            used = extent;
+            if(!failed && ::ftruncate(fd, static_cast<off_t>(offset)) < 0)
+                failed = true;
+            ::close(fd);
+            fd = -1;
+        }
+
+    private:
+        bool grow(size_t n)
+        {
+            if(::ftruncate(fd, static_cast<off_t>(n)) < 0)
+                return false;
+            file_size = n;
+            return true;
+        }
+
+        // maps the extent at offset, growing the file to hold it
+        bool map_window()
+        {
+            if(file_size < offset + extent && !grow(offset + extent))
+                return false;
+            void* p = ::mmap(nullptr, extent, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                             static_cast<off_t>(offset));
+            if(p == MAP_FAILED)
+                return false;
+            map = static_cast<char*>(p);
+            if(sequential)
+                ::madvise(p, extent, MADV_SEQUENTIAL);
+            return true;
+        }
+
+        bool next_window()
+        {
+            if(!map)
+                return false;
+            ::munmap(map, extent);
+            map = nullptr;
+            offset += extent;
+            if(!map_window())
+                return fail(), false;
+            used = 0;
+            return true;
+        }
+
+        // keeps the offset bytes printed so far and discards everything after
+        void fail()
+        {
+            if(fd >= 0)
+            {
+                if(file_size > offset)
+                    (void)::ftruncate(fd, static_cast<off_t>(offset));
+                ::close(fd);
+                fd = -1;
+            }
+            failed = true;
+        }
+
+        // while unmapped, used is extent so that printing tries to map the next window and
+        // offset is the size of the file
+        int fd = -1;
+        char* map = nullptr;
+        size_t extent;
+        size_t offset = 0;
+        size_t used;
+        size_t file_size = 0;
+        bool sequential;
+        bool failed = false;
+    };
+
+    template <typename... Ts>
+    inline void fprint(mmap_sink& sink, Ts&&... ts)
+    {
+        detail::stats_scope<Ts...> stats;
+        detail::writer w{stats.wrap(sink.begin())};
+        detail::fprint(w, std::forward<Ts>(ts)...);
+    }
+
+    template <typename... Ts>
+    inline void fprintln(mmap_sink& sink, Ts&&... ts)
+    {
+        fprint(sink, std::forward<Ts>(ts)...);
+        sink.put('\n');
+    }
+#endif // EZPRINT_ENABLE_POSIX
+
+    // appends to s, which grows at most once and not at all when it has the capacity
+    template <typename Traits, typename Alloc, typename... Ts>
+    inline std::basic_string<char, Traits, Alloc>&
+    sprint_to(std::basic_string<char, Traits, Alloc>& s, Ts&&... ts)
+    {
+        // measuring first resizes the string exactly once
+        detail::stats_scope<Ts...> stats;
+        auto old = s.size();
+        detail::writer<detail::counting_iterator> counter{detail::counting_iterator{}};
+        detail::fprint(counter, ts...);
+        auto size = counter.out().n;
+        s.resize(old + size);
+        detail::writer<detail::truncating_iterator<char*>> w{
+            detail::truncating_iterator<char*>(s.data() + old, size), counter.numeric_locale()};
+        detail::fprint(w, ts...);
+
+        // only when some operator<< prints differently the second time
+        if(w.out().n != size)
+        {
+            s.resize(old);
+            format_to(std::back_inserter(s), ts...);
+        }
+        stats.add_bytes(s.size() - old);
+        return s;
+    }
+
+    template <typename... Ts>
+    inline std::string sprint(Ts&&... ts)
+    {
+        std::string s;
+        sprint_to(s, ts...);
+        return s;
+    }
+
+    // same as sprint, with the string allocated by alloc, e.g. a std::pmr::polymorphic_allocator
+    template <typename Alloc, typename... Ts>
+    inline std::basic_string<char, std::char_traits<char>, Alloc>
+    sprint(std::allocator_arg_t, Alloc alloc, Ts&&... ts)
+    {
+        std::basic_string<char, std::char_traits<char>, Alloc> s(alloc);
+        sprint_to(s, ts...);
+        return s;
+    }
+
+    // string of at most N characters stored inline, returned by sprint_n
+    template <size_t N>
+    class fixed_string
+    {
+    public:
+        const char* data() const { return buf; }
+        const char* c_str() const { return buf; }
+        size_t size() const { return n; }
+        static constexpr size_t capacity() { return N; }
+
+        // number of characters that didn't fit, 0 if none
+        size_t overflow() const { return total - n; }
+
+        std::string_view view() const { return {buf, n}; }
+        operator std::string_view() const { return view(); }
+
+        friend std::ostream& operator<<(std::ostream& os, const fixed_string& s)
+        {
+            return os << s.view();
+        }
+
+        template <size_t M, typename... Ts>
+        friend fixed_string<M> sprint_n(Ts&&... ts);
+
+    private:
+        char buf[N + 1] = {};
+        size_t n = 0;
+        size_t total = 0;
+    };
+
+    // prints into a fixed_string without allocating, output past N characters is cut off
+    template <size_t N, typename... Ts>
+    inline fixed_string<N> sprint_n(Ts&&... ts)
+    {
+        fixed_string<N> s;
+        detail::stats_scope<Ts...> stats;
+        auto res = format_to_n(s.buf, N, std::forward<Ts>(ts)...);
+        s.total = static_cast<size_t>(res.size);
+        s.n = std::min(s.total, N);
+        stats.add_bytes(s.n);
+        s.buf[s.n] = '\0';
+        return s;
+    }
+
+    template <typename... Ts>
+    inline std::string sprint(limits lim, Ts&&... ts)
+    {
+        std::string s;
+        detail::stats_scope<Ts...> stats;
+        detail::limited_writer w(std::back_inserter(s), lim);
+        detail::fprint(w, std::forward<Ts>(ts)...);
+        w.finish();
+        stats.add_bytes(s.size());
+        return s;
+    }
+
+    // keeps the text sprint prints for a value, and prints it again only when told it changed
+    // sized random access ranges are printed in chunks, of which only those with elements
+    // marked by touch are printed again, the whole range is printed again when its size changes
+    template <typename T>
+    class cached_view
+    {
+    public:
+        // elements per chunk of a range
+        static constexpr size_t chunk = 256;
+
+        explicit cached_view(const T& value) : value(&value) {}
+        // the view keeps a pointer to the value, which a temporary wouldn't outlive
+        cached_view(const T&&) = delete;
+
+        // the text of the value, printed again where it was touched or invalidated
+        std::string_view get()
+        {
+            if constexpr(is_range)
+                if(std::size(*value) != size)
+                    valid = false;
+            if(!valid)
+                render();
+            else if constexpr(is_range)
+                if(touched)
+                    render_touched();
+            return text;
+        }
+
+        // same as get, and prints everything again if stamp differs from the last one passed
+        // stamp is something that changes with the value, e.g. a version number or a hash
+        std::string_view get(std::uint64_t stamp)
+        {
+            if(stamp != last_stamp)
+                valid = false;
+            last_stamp = stamp;
+            return get();
+        }
+
+        // marks the i-th element of a range as changed
+        void touch(size_t i)
+        {
+            static_assert(is_range, "only ranges have elements to touch");
+            if(valid && i / chunk < lengths.size())
+            {
+                dirty[i / chunk] = true;
+                touched = true;
+            }
+        }
+
+        // marks everything as changed
+        void invalidate() { valid = false; }
+
+    private:
+        static constexpr bool is_range = detail::is_parallel_range_v<const T&>;
+
+        void render()
+        {
+            text.clear();
+            if constexpr(is_range)
+            {
+                using std::begin;
+                size = std::size(*value);
+                size_t nchunks = (size + chunk - 1) / chunk;
+                starts.resize(nchunks);
+                lengths.resize(nchunks);
+                dirty.assign(nchunks, false);
+
+                text += '{';
+                for(size_t c = 0; c < nchunks; c++)
+                {
+                    if(c > 0)
+                        text += ' ';
+                    starts[c] = text.size();
+                    detail::writer w{std::back_inserter(text)};
+                    detail::fprint_elements(w, begin(*value) + c * chunk,
+                                            begin(*value) + std::min(size, (c + 1) * chunk));
+                    lengths[c] = text.size() - starts[c];
+                }
+                text += '}';
+            }
+            else
+                sprint_to(text, *value);
+            valid = true;
+            touched = false;
+        }
+
+        // splices the touched chunks, printed again, into the text
+        void render_touched()
+        {
+            using std::begin;
+            std::string s;
+            std::ptrdiff_t shift = 0;
+            for(size_t c = 0; c < lengths.size(); c++)
+            {
+                starts[c] += shift;
+                if(!dirty[c])
+                    continue;
+
+                s.clear();
+                detail::writer w{std::back_inserter(s)};
+                detail::fprint_elements(w, begin(*value) + c * chunk,
+                                        begin(*value) + std::min(size, (c + 1) * chunk));
+                text.replace(starts[c], lengths[c], s);
+                shift += static_cast<std::ptrdiff_t>(s.size()) - static_cast<std::ptrdiff_t>(lengths[c]);
+                lengths[c] = s.size();
+                dirty[c] = false;
+            }
+            touched = false;
+        }
+
+        const T* value;
+        std::string text;
+        std::uint64_t last_stamp = 0;
+        bool valid = false;
+        bool touched = false;
+
+        // size of the range and where each of its chunks is in text
+        size_t size = 0;
+        std::vector<size_t> starts;
+        std::vector<size_t> lengths;
+        std::vector<bool> dirty;
+    };
+
+#if EZPRINT_ENABLE_STATS
+    // counters of what was printed with one list of argument types or from one call site
+    // elements are the leaves printed, including those of nested calls from within operator<<
+    struct stats_entry
+    {
+        std::string name;
+        std::uint64_t calls;
+        std::uint64_t bytes;
+        std::uint64_t elements;
+        std::uint64_t nanoseconds;
+    };
+
+    // call sites are only known for printf and friends, only from C++20 and with
+    // EZPRINT_DIRECT_FORMAT
+    struct print_stats
+    {
+        std::vector<stats_entry> types;
+        std::vector<stats_entry> sites;
+    };
+
+    // sums up the counters of all threads, the most time consuming first
+    inline print_stats stats_snapshot()
+    {
+        auto& reg = detail::global_stats();
+        std::lock_guard lock(reg.mutex);
+        auto totals = reg.retired;
+        for(auto t : reg.threads)
+            t->collect(totals);
+
+        print_stats stats;
+        for(size_t i = 0; i < std::min(totals.size(), reg.names.size()); i++)
+        {
+            auto& t = totals[i];
+            if(t.calls == 0)
+                continue;
+            auto& entries = reg.sites[i] ? stats.sites : stats.types;
+            entries.push_back({reg.names[i], t.calls, t.bytes, t.elements, t.nanoseconds});
+        }
+        for(auto entries : {&stats.types, &stats.sites})
+            std::sort(entries->begin(), entries->end(), [](auto& a, auto& b) {
+                return a.nanoseconds > b.nanoseconds;
+            });
+        return stats;
+    }
+#endif // EZPRINT_ENABLE_STATS
+
+#if EZPRINT_ENABLE_ASYNC
+    namespace detail
+    {
+        // copy of an argument that stays printable after the caller's objects are gone
+        // char arrays become strings and other arrays std::array, rather than decaying
+        template <typename T>
+        inline auto capture(T&& t)
+        {
+            using rT = std::remove_cv_t<std::remove_reference_t<T>>;
+            if constexpr(std::is_array_v<rT> && is_string_of_v<rT, char>)
+                return std::string(t);
+            else if constexpr(std::is_array_v<rT>)
+                return index_upto<std::extent_v<rT>>(
+                    [&](auto... is) { return std::array{capture(t[decltype(is){}])...}; });
+            else
+                return rT(std::forward<T>(t));
+        }
+
+        // bounded lock-free queue of print tasks, many threads push and one thread pops
+        // each cell has a sequence number telling whether it is free for the push of
+        // position pos (seq == pos) or holds the task of position pos (seq == pos + 1)
+        class task_queue
+        {
+        public:
+            // tasks of up to this size are stored in the queue, larger ones on the heap
+            static constexpr size_t inline_size = 112;
+
+            explicit task_queue(size_t capacity)
+            {
+                size_t n = 1;
+                while(n < capacity)
+                    n *= 2;
+                cells = std::make_unique<cell[]>(n);
+                mask = n - 1;
+                for(size_t i = 0; i < n; i++)
+                    cells[i].seq.store(i, std::memory_order_relaxed);
+            }
+
+            ~task_queue()
+            {
+                while(pop(nullptr))
+                    ;
+            }
+
+            // returns false if the queue is full
+            template <typename F>
+            bool try_push(F&& f)
+            {
+                using fT = std::decay_t<F>;
+                auto pos = tail.load(std::memory_order_relaxed);
+                cell* c;
+                for(;;)
+                {
+                    c = &cells[pos & mask];
+                    auto seq = c->seq.load(std::memory_order_acquire);
+                    auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+                    if(diff == 0)
+                    {
+                        if(tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                            break;
+                    }
+                    else if(diff < 0)
+                        return false;
+                    else
+                        pos = tail.load(std::memory_order_relaxed);
+                }
+
+                if constexpr(sizeof(fT) <= inline_size && alignof(fT) <= alignof(std::max_align_t))
+                {
+                    new(c->storage) fT(std::forward<F>(f));
+                    c->run = [](void* p, std::ostream* os) {
+                        // the task is destroyed even if printing throws
+                        struct destroy
+                        {
+                            fT& f;
+                            ~destroy() { f.~fT(); }
+                        } d{*static_cast<fT*>(p)};
+                        if(os)
+                            d.f(*os);
+                    };
+                }
+                else
+                {
+                    new(c->storage) fT*(new fT(std::forward<F>(f)));
+                    c->run = [](void* p, std::ostream* os) {
+                        std::unique_ptr<fT> f(*static_cast<fT**>(p));
+                        if(os)
+                            (*f)(*os);
+                    };
+                }
+                c->seq.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+
+            // runs the oldest task on os, or only destroys it if os is null
+            // returns false if the queue is empty
+            bool pop(std::ostream* os)
+            {
+                auto& c = cells[head & mask];
+                if(c.seq.load(std::memory_order_acquire) != head + 1)
+                    return false;
+
+                // the cell is released even if printing throws
+                struct release
+                {
+                    cell& c;
+                    size_t next;
+                    ~release() { c.seq.store(next, std::memory_order_release); }
+                } r{c, head + mask + 1};
+                head++;
+                c.run(c.storage, os);
+                return true;
+            }
+
+        private:
+            struct cell
+            {
+                std::atomic<size_t> seq;
+                void (*run)(void*, std::ostream*);
+                alignas(std::max_align_t) unsigned char storage[inline_size];
+            };
+
+            std::unique_ptr<cell[]> cells;
+            size_t mask;
+            alignas(64) std::atomic<size_t> tail{0};
+            alignas(64) size_t head = 0;
+        };
+    } // namespace detail
+
+    // what async_printer does with a line when its queue is full
+    // block waits for room, drop discards the line, count_dropped discards the line and
+    // later prints how many lines were discarded
+    enum class overflow_policy
+    {
+        block,
+        drop,
+        count_dropped,
+    };
+
+    // prints lines on a background thread
+    // arguments are copied into a bounded lock-free queue and printed with fprintln by the
+    // background thread, pointers and views are copied as is and must outlive the printing
+    class async_printer
+    {
+    public:
+        explicit async_printer(std::ostream& os = std::cout, size_t capacity = 4096,
+                               overflow_policy policy = overflow_policy::block)
+            : os(os), policy(policy), queue(capacity), consumer([this] { run(); })
+        {
+        }
+
+        async_printer(const async_printer&) = delete;
+        async_printer& operator=(const async_printer&) = delete;
+
+        ~async_printer() { shutdown(); }
+
+        template <typename... Ts>
+        void println(Ts&&... ts)
+        {
+            push([args = std::make_tuple(detail::capture(std::forward<Ts>(ts))...)](
+                     std::ostream& os) { std::apply([&](auto&... xs) { fprintln(os, xs...); }, args); },
+                 policy);
+        }
+
+        // waits until everything printed before the call is written and os is flushed
+        void flush()
+        {
+            std::promise<void> done;
+            auto future = done.get_future();
+            if(!push([&done](std::ostream& os) {
+                   os.flush();
+                   done.set_value();
+               },
+               overflow_policy::block))
+                return;
+            future.wait();
+        }
+
+        // prints everything in the queue and stops the background thread,
+        // lines printed afterwards are dropped
+        void shutdown()
+        {
+            if(stopped.exchange(true))
+                return;
+            while(pushing != 0)
+                std::this_thread::yield();
+            closed.store(true, std::memory_order_release);
+            consumer.join();
+            os.flush();
+        }
+
+        // number of lines dropped so far
+        size_t dropped() const { return ndropped.load(std::memory_order_relaxed); }
+
+    private:
+        // f is only moved from once it has a place in the queue
+        template <typename F>
+        bool push(F&& f, overflow_policy p)
+        {
+            // shutdown waits for pushes in progress, so that every line is printed or dropped
+            struct in_progress
+            {
+                std::atomic<size_t>& n;
+                explicit in_progress(std::atomic<size_t>& n) : n(n) { n++; }
+                ~in_progress() { n--; }
+            } guard(pushing);
+
+            while(!stopped)
+            {
+                if(queue.try_push(std::forward<F>(f)))
+                    return true;
+                if(p != overflow_policy::block)
+                    break;
+                std::this_thread::yield();
+            }
+            ndropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        void run()
+        {
+            size_t reported = 0;
+            int idle = 0;
+            for(;;)
+            {
+                bool stopping = closed.load(std::memory_order_acquire);
+                if(policy == overflow_policy::count_dropped)
+                {
+                    auto n = dropped();
+                    if(n != reported)
+                    {
+                        fprintln(os, "!(" + std::to_string(n - reported) + " LINES DROPPED)");
+                        reported = n;
+                    }
+                }
+
+                bool popped;
+                try
+                {
+                    popped = queue.pop(&os);
+                }
+                catch(...)
+                {
+                    popped = true;
+                }
+
+                if(popped)
+                {
+                    idle = 0;
+                    continue;
+                }
+                if(stopping)
+                    return;
+
+                // spin briefly, then back off to sleeping so an idle printer costs nothing
+                if(idle == 0)
+                    os.flush();
+                if(idle < 64)
+                    std::this_thread::yield();
+                else
+                    std::this_thread::sleep_for(std::chrono::microseconds(std::min(idle, 1000)));
+                idle++;
+            }
+        }
+
+        std::ostream& os;
+        overflow_policy policy;
+        detail::task_queue queue;
+        // stopped is set first, closed once no push is in progress any more
+        std::atomic<bool> stopped{false};
+        std::atomic<bool> closed{false};
+        std::atomic<size_t> pushing{0};
+        std::atomic<size_t> ndropped{0};
+        std::thread consumer;
+    };
+
+    // the printer used by async_println, printing to std::cout
+    inline async_printer& default_async_printer()
+    {
+        static async_printer printer;
+        return printer;
+    }
+
+    template <typename... Ts>
+    inline void async_println(Ts&&... ts)
+    {
+        default_async_printer().println(std::forward<Ts>(ts)...);
+    }
+
+    inline void async_flush()
+    {
+        default_async_printer().flush();
+    }
+#endif // EZPRINT_ENABLE_ASYNC
+
+    namespace detail
+    {
+        // records of capture_log
+        // a schema record describes the argument types of a print call once, and data records
+        // with the same id only hold the values, laid out as the schema says
+        //     'S' varint id, u32 length, schema
+        //     'R' varint id, u32 length, values
+        // schema codes, followed by the layout of their values
+        //     i<n> u<n>     signed and unsigned integers of n bytes    raw bytes
+        //     f d e         float, double, long double                 raw bytes
+        //     b c           bool, char                                 1 byte
+        //     s             strings and streamable leaves              varint length, bytes
+        //     r<e>          range of e                                 varint count, elements
+        //     m<k><v>       associative range                          varint count, pairs
+        //     t<n><e...>    tuple or aggregate of n fields             fields
+        //     x             unknown type                               nothing
+        //     a<n><e...>    the n arguments of the print call          arguments
+        inline void append_varint(std::string& s, std::uint64_t n)
+        {
+            for(; n >= 0x80; n >>= 7)
+                s += static_cast<char>(n | 0x80);
+            s += static_cast<char>(n);
+        }
+
+        template <typename T>
+        inline void append_raw(std::string& s, const T& t)
+        {
+            s.append(reinterpret_cast<const char*>(&t), sizeof(T));
+        }
+
+        // T is the type fprint would be called with
+        template <typename T>
+        inline void append_schema(std::string& s)
+        {
+            using rT = std::remove_reference_t<T>;
+            using U = std::remove_cv_t<rT>;
+
+            if constexpr(std::experimental::is_detected_v<stream_t, T> && (!std::is_array_v<rT> || is_string_v<rT>))
+            {
+                if constexpr(std::is_same_v<U, bool>)
+                    s += 'b';
+                else if constexpr(std::is_same_v<U, char>)
+                    s += 'c';
+                else if constexpr(is_number_v<U> && std::is_integral_v<U>)
+                {
+                    s += std::is_signed_v<U> ? 'i' : 'u';
+                    s += static_cast<char>('0' + sizeof(U));
+                }
+                else if constexpr(is_number_v<U>)
+                    s += std::is_same_v<U, float> ? 'f' : std::is_same_v<U, double> ? 'd' : 'e';
+                else
+                    s += 's';
+            }
+            else if constexpr(std::experimental::is_detected_v<begin_t, T> &&
+                              std::experimental::is_detected_v<end_t, T>)
+            {
+                using E = decltype(*begin(std::declval<T>()));
+                if constexpr(std::experimental::is_detected_v<mapped_type, rT>)
+                {
+                    s += 'm';
+                    append_schema<decltype((std::declval<E>().first))>(s);
+                    append_schema<decltype((std::declval<E>().second))>(s);
+                }
+                else
+                {
+                    s += 'r';
+                    append_schema<std::remove_reference_t<E>&>(s);
+                }
+            }
+            else if constexpr(std::experimental::is_detected_v<tuple_size_t, rT>)
+            {
+                s += 't';
+                append_varint(s, std::tuple_size_v<rT>);
+                index_upto<std::tuple_size_v<rT>>([&](auto... is) {
+                    (append_schema<decltype(get<decltype(is){}>(std::declval<T>()))>(s), ...);
+                });
+            }
+            else if constexpr(std::is_aggregate_v<rT>)
+                append_schema<decltype(as_tuple(std::declval<T>(), count_t<rT>{}))>(s);
+            else
+                s += 'x';
+        }
+
+        // mirrors fprint, appending the values as laid out by append_schema
+        template <typename T>
+        inline void append_values(std::string& s, T&& t)
+        {
+            using rT = std::remove_reference_t<T>;
+            using U = std::remove_cv_t<rT>;
+
+            if constexpr(std::experimental::is_detected_v<stream_t, T> && (!std::is_array_v<rT> || is_string_v<rT>))
+            {
+                if constexpr(std::is_same_v<U, char> || is_number_v<U>)
+                    append_raw(s, t);
+                else if constexpr(is_char_ptr_v<T> && !std::is_array_v<rT>)
+                {
+                    std::string_view sv = t ? std::string_view(t) : std::string_view();
+                    append_varint(s, sv.size());
+                    s += sv;
+                }
+                else if constexpr(std::is_convertible_v<T, std::string_view>)
+                {
+                    std::string_view sv = t;
+                    append_varint(s, sv.size());
+                    s += sv;
+                }
+                else
+                {
+                    // operator<< can't be deferred, so its output is what is stored
+                    auto len = s.size();
+                    s += std::string(10, '\0');
+                    format_to(std::back_inserter(s), t);
+                    std::string prefix;
+                    append_varint(prefix, s.size() - len - 10);
+                    s.replace(len, 10, prefix);
+                }
+            }
+            else if constexpr(std::experimental::is_detected_v<begin_t, T> &&
+                              std::experimental::is_detected_v<end_t, T>)
+            {
+                if constexpr(is_contiguous_numbers_v<T>)
+                {
+                    auto n = std::size(t);
+                    append_varint(s, n);
+                    s.append(reinterpret_cast<const char*>(std::data(t)), n * sizeof(*std::data(t)));
+                }
+                else
+                {
+                    if constexpr(std::experimental::is_detected_v<container_size_t, T>)
+                        append_varint(s, std::size(t));
+                    else
+                        append_varint(s, std::distance(begin(t), end(t)));
+
+                    for(auto&& x : t)
+                    {
+                        if constexpr(std::experimental::is_detected_v<mapped_type, rT>)
+                        {
+                            append_values(s, x.first);
+                            append_values(s, x.second);
+                        }
+                        else
+                            append_values(s, x);
+                    }
+                }
+            }
+            else if constexpr(std::experimental::is_detected_v<tuple_size_t, rT>)
+                index_upto<std::tuple_size_v<rT>>(
+                    [&](auto... is) { (append_values(s, get<decltype(is){}>(t)), ...); });
+            else if constexpr(std::is_aggregate_v<rT>)
+                append_values(s, as_tuple(t, count_t<rT>{}));
+        }
+
+        inline std::uint32_t next_schema_id()
+        {
+            static std::atomic<std::uint32_t> id{0};
+            return id++;
+        }
+
+        template <typename... Ts>
+        struct schema_of
+        {
+            static inline const std::uint32_t id = next_schema_id();
+            static inline const std::string schema = [] {
+                std::string s = "a";
+                append_varint(s, sizeof...(Ts));
+                (append_schema<const Ts&>(s), ...);
+                return s;
+            }();
+        };
+
+        // reads the values of a data record, bounds checked
+        struct record_reader
+        {
+            const char* p;
+            const char* end;
+            // how many more elements may take no bytes, which bounds what a record can print
+            std::uint64_t empty_budget = 1 << 20;
+
+            bool read(void* dst, size_t n)
+            {
+                if(static_cast<size_t>(end - p) < n)
+                    return false;
+                std::memcpy(dst, p, n);
+                p += n;
+                return true;
+            }
+
+            bool read_varint(std::uint64_t& n)
+            {
+                n = 0;
+                for(int shift = 0; p != end && shift < 64; shift += 7)
+                {
+                    auto b = static_cast<unsigned char>(*p++);
+                    n |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+                    if(b < 0x80)
+                        return true;
+                }
+                return false;
+            }
+        };
+
+        template <typename T>
+        inline bool decode_number(record_reader& r, std::string& out)
+        {
+            // read as bytes, not every byte is a valid bool
+            using raw = std::conditional_t<std::is_same_v<T, bool>, unsigned char, T>;
+            raw n;
+            if(!r.read(&n, sizeof(raw)))
+                return false;
+            char buf[max_number_chars];
+            out.append(buf, write_number(buf, static_cast<T>(n)));
+            return true;
+        }
+
+        // schemas nested deeper than this are malformed, before they run out of stack
+        inline constexpr size_t max_schema_depth = 256;
+
+        // returns the end of the schema starting at sch, or null if it is malformed
+        inline const char* skip_schema(const char* sch, const char* sch_end, size_t depth = 0)
+        {
+            if(sch == sch_end || depth >= max_schema_depth)
+                return nullptr;
+            record_reader r{sch + 1, sch_end};
+            std::uint64_t n;
+            switch(*sch)
+            {
+            case 'i':
+            case 'u':
+                return sch + 2 <= sch_end ? sch + 2 : nullptr;
+            case 'f':
+            case 'd':
+            case 'e':
+            case 'b':
+            case 'c':
+            case 's':
+            case 'x':
+                return sch + 1;
+            case 'r':
+                return skip_schema(sch + 1, sch_end, depth + 1);
+            case 'm':
+                sch = skip_schema(sch + 1, sch_end, depth + 1);
+                return sch ? skip_schema(sch, sch_end, depth + 1) : nullptr;
+            case 't':
+            case 'a':
+                if(!r.read_varint(n))
+                    return nullptr;
+                sch = r.p;
+                for(; sch && n > 0; n--)
+                    sch = skip_schema(sch, sch_end, depth + 1);
+                return sch;
+            default:
+                return nullptr;
+            }
+        }
+
+        // prints the value described by sch and read from r as fprint does,
+        // returns the end of the schema, or null if the record is malformed
+        inline const char* decode_value(const char* sch, const char* sch_end, record_reader& r,
+                                        std::string& out, size_t depth = 0)
+        {
+            if(sch == sch_end || depth >= max_schema_depth)
+                return nullptr;
+
+            record_reader sr{sch + 1, sch_end};
+            std::uint64_t n;
+            bool ok = true;
+            switch(*sch++)
+            {
+            case 'i':
+            case 'u':
+            {
+                if(sch == sch_end)
+                    return nullptr;
+                bool sign = sch[-1] == 'i';
+                switch(*sch++)
+                {
+                case '1': ok = sign ? decode_number<std::int8_t>(r, out) : decode_number<std::uint8_t>(r, out); break;
+                case '2': ok = sign ? decode_number<std::int16_t>(r, out) : decode_number<std::uint16_t>(r, out); break;
+                case '4': ok = sign ? decode_number<std::int32_t>(r, out) : decode_number<std::uint32_t>(r, out); break;
+                case '8': ok = sign ? decode_number<std::int64_t>(r, out) : decode_number<std::uint64_t>(r, out); break;
+                default: return nullptr;
+                }
+                break;
+            }
+            case 'f':
+                ok = decode_number<float>(r, out);
+                break;
+            case 'd':
+                ok = decode_number<double>(r, out);
+                break;
+            case 'e':
+                ok = decode_number<long double>(r, out);
+                break;
+            case 'b':
+                ok = decode_number<bool>(r, out);
+                break;
+            case 'c':
+            {
+                char c = 0;
+                ok = r.read(&c, 1);
+                if(ok)
+                    out += c;
+                break;
+            }
+            case 's':
+                ok = r.read_varint(n) && static_cast<std::uint64_t>(r.end - r.p) >= n;
+                if(ok)
+                {
+                    out.append(r.p, n);
+                    r.p += n;
+                }
+                break;
+            case 'r':
+            case 'm':
+            {
+                bool map = sch[-1] == 'm';
+                if(!r.read_varint(n))
+                    return nullptr;
+                auto elem_end = map ? skip_schema(sch, sch_end, depth + 1) : sch;
+                if(map && elem_end)
+                    elem_end = skip_schema(elem_end, sch_end, depth + 1);
+                else if(!map)
+                    elem_end = skip_schema(sch, sch_end, depth + 1);
+                if(!elem_end)
+                    return nullptr;
+                // each element takes at least a byte, or some of the budget
+                if(n > static_cast<std::uint64_t>(r.end - r.p) + r.empty_budget)
+                    return nullptr;
+
+                out += '{';
+                for(std::uint64_t i = 0; i < n; i++)
+                {
+                    if(i > 0)
+                        out += ' ';
+                    auto p = r.p;
+                    auto next = decode_value(sch, sch_end, r, out, depth + 1);
+                    if(next && map)
+                    {
+                        out += ": ";
+                        next = decode_value(next, sch_end, r, out, depth + 1);
+                    }
+                    if(!next || (r.p == p && r.empty_budget-- == 0))
+                        return nullptr;
+                }
+                out += '}';
+                return elem_end;
+            }
+            case 't':
+            case 'a':
+            {
+                bool args = sch[-1] == 'a';
+                if(!sr.read_varint(n))
+                    return nullptr;
+                sch = sr.p;
+                if(!args)
+                    out += '{';
+                for(std::uint64_t i = 0; i < n; i++)
+                {
+                    if(i > 0)
+                        out += ' ';
+                    if(!(sch = decode_value(sch, sch_end, r, out, depth + 1)))
+                        return nullptr;
+                }
+                if(!args)
+                    out += '}';
+                return sch;
+            }
+            case 'x':
+                out += "!(UNKNOWN TYPE)";
+                break;
+            default:
+                return nullptr;
+            }
+            return ok ? sch : nullptr;
+        }
+    } // namespace detail
+
+    // prints into a compact binary log instead of text, which decode turns into the text
+    // println would have printed with default formatting flags and the classic locale
+    // numbers and strings are copied as raw bytes, types that only have an operator<<
+    // are printed when captured
+    // the log is only readable on machines with the same type sizes and endianness
+    class capture_log
+    {
+    public:
+        explicit capture_log(std::ostream& os) : os(os) {}
+        capture_log(const capture_log&) = delete;
+        capture_log& operator=(const capture_log&) = delete;
+        ~capture_log() { flush(); }
+
+        template <typename... Ts>
+        void println(const Ts&... ts)
+        {
+            // schemas are numbered in the log in the order they are first written to it
+            using schema = detail::schema_of<Ts...>;
+            if(schema::id >= ids.size())
+                ids.resize(schema::id + 1);
+            auto& id = ids[schema::id];
+            if(id == 0)
+            {
+                id = ++nschemas;
+                begin_record('S', id - 1);
+                buf += schema::schema;
+                end_record();
+            }
+
+            begin_record('R', id - 1);
+            (detail::append_values(buf, ts), ...);
+            end_record();
+
+            if(buf.size() >= 1 << 16)
+                flush();
+        }
+
+        void flush()
+        {
+            os.write(buf.data(), buf.size());
+            os.flush();
+            buf.clear();
+        }
+
+    private:
+        void begin_record(char tag, std::uint32_t id)
+        {
+            buf += tag;
+            detail::append_varint(buf, id);
+            start = buf.size();
+            buf.append(4, '\0');
+        }
+
+        void end_record()
+        {
+            auto len = static_cast<std::uint32_t>(buf.size() - start - 4);
+            std::memcpy(&buf[start], &len, 4);
+        }
+
+        std::ostream& os;
+        std::string buf;
+        size_t start = 0;
+        // the number in the log plus one of each schema, zero if it isn't written yet
+        std::vector<std::uint32_t> ids;
+        std::uint32_t nschemas = 0;
+    };
+
+    // prints the lines of a capture_log read from is to os
+    // returns false if the log is malformed
+    inline bool decode(std::istream& is, std::ostream& os)
+    {
+        std::vector<std::string> schemas;
+        std::string body;
+        std::string line;
+        char tag;
+        while(is.get(tag))
+        {
+            std::uint64_t id = 0;
+            for(int shift = 0;; shift += 7)
+            {
+                char b;
+                if(shift >= 64 || !is.get(b))
+                    return false;
+                id |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+                if(static_cast<unsigned char>(b) < 0x80)
+                    break;
+            }
+
+            // read in pieces, so that a corrupt length fails on the end of the input
+            // instead of allocating what it says
+            std::uint32_t len;
+            if(!is.read(reinterpret_cast<char*>(&len), 4))
+                return false;
+            body.clear();
+            for(size_t left = len; left > 0;)
+            {
+                size_t n = std::min<size_t>(left, 1 << 16);
+                auto old = body.size();
+                body.resize(old + n);
+                if(!is.read(body.data() + old, n))
+                    return false;
+                left -= n;
+            }
+
+            // schemas are numbered in order
+            if(tag == 'S' && id == schemas.size())
+                schemas.push_back(body);
+            else if(tag == 'R' && id < schemas.size() && !schemas[id].empty())
+            {
+                auto& sch = schemas[id];
+                detail::record_reader r{body.data(), body.data() + body.size()};
+                line.clear();
+                if(!detail::decode_value(sch.data(), sch.data() + sch.size(), r, line))
+                    return false;
+                line += '\n';
+                os.write(line.data(), line.size());
+            }
+            else
+                return false;
+        }
+        return true;
+    }
+
+#if EZPRINT_ENABLE_FORMAT
+    namespace detail
     {
 #if __cplusplus >= 202302L
         template<typename T>
@@ -414,6 +4059,23 @@ namespace ez
         template<typename T>
         inline constexpr bool formattable = formattable_t<T>::value;
 #endif // __cplusplus >= 202302L
+#if EZPRINT_ENABLE_DIRECT_FORMAT
+        // arguments std::format can't format, printed on demand by the formatter below
+        template<typename T>
+        struct ez_value
+        {
+            T& x;
+        };
+
+        template<typename T>
+        decltype(auto) ez_arg(T&& x)
+        {
+            if constexpr(formattable<T>)
+                return std::forward<T>(x);
+            else
+                return ez_value<std::remove_reference_t<T>>{x};
+        }
+#else
         template<typename T>
         decltype(auto) ez_arg(T&& x)
         {
@@ -422,44 +4084,273 @@ namespace ez
             else
                 return sprint(x);
         }
+#endif // EZPRINT_ENABLE_DIRECT_FORMAT
 
         template<typename T>
         using ez_arg_value_t = decltype(ez_arg(std::declval<T>()));
+
+        // calls f with the format args of args, which are alive for the duration of the call
+        template<typename F, typename... Args>
+        decltype(auto) with_format_args(F&& f, Args&... args)
+        {
+            std::tuple<decltype(ez_arg(args))...> values{ez_arg(args)...};
+            return std::apply([&](auto&... vs) { return f(std::make_format_args(vs...)); }, values);
+        }
+
+#if EZPRINT_ENABLE_DIRECT_FORMAT
+        template<typename T>
+        inline constexpr char type_key = 0;
+
+        // writer applying a format specification to every leaf that std::format accepts it for
+        // leaves of other types are printed as usual
+        template<typename Ctx>
+        class spec_writer : public writer<typename Ctx::iterator>
+        {
+            using base = writer<typename Ctx::iterator>;
+
+        public:
+            spec_writer(Ctx& ctx, std::string_view spec) : base(ctx.out()), ctx(ctx), spec(spec) {}
+
+            template<typename T>
+            void leaf(T&& t)
+            {
+                using rT = std::remove_cvref_t<T>;
+                if constexpr(formattable<T> && !std::is_same_v<rT, bool>)
+                    if(!spec.empty() && !rejected(&type_key<rT>))
+                    {
+                        std::formatter<rT> f;
+                        std::format_parse_context pc(spec);
+                        try
+                        {
+                            if(f.parse(pc) != pc.end())
+                                throw std::format_error("unconsumed format specification");
+                        }
+                        catch(const std::format_error&)
+                        {
+                            reject(&type_key<rT>);
+                            return base::leaf(t);
+                        }
+
+#if EZPRINT_ENABLE_STATS
+                        this->count_leaf();
+#endif // EZPRINT_ENABLE_STATS
+                        ctx.advance_to(this->out());
+                        this->advance_to(f.format(t, ctx));
+                        return;
+                    }
+
+                base::leaf(t);
+            }
+
+            bool plain_numbers() const { return spec.empty() && base::plain_numbers(); }
+
+        private:
+            bool rejected(const void* key) const
+            {
+                return std::find(keys, keys + nkeys, key) != keys + nkeys;
+            }
+
+            void reject(const void* key)
+            {
+                if(nkeys < std::size(keys))
+                    keys[nkeys++] = key;
+            }
+
+            Ctx& ctx;
+            std::string_view spec;
+
+            // leaf types the specification is invalid for
+            const void* keys[8];
+            size_t nkeys = 0;
+        };
+#endif // EZPRINT_ENABLE_DIRECT_FORMAT
+    }
+
+#if EZPRINT_ENABLE_STATS && EZPRINT_ENABLE_DIRECT_FORMAT && __cpp_lib_source_location >= 201907L
+    namespace detail
+    {
+        // format string that remembers where it was written, so stats are kept per call site
+        template<typename... Args>
+        struct located_format_string
+        {
+            template<typename S>
+                requires std::convertible_to<const S&, std::string_view>
+            consteval located_format_string(
+                const S& s, std::source_location loc = std::source_location::current()
+            )
+                : fmt(s), loc(loc)
+            {
+            }
+
+            constexpr std::string_view get() const { return fmt.get(); }
+
+            std::format_string<Args...> fmt;
+            std::source_location loc;
+        };
     }
 
+    template<typename... Args>
+    using format_string_of = detail::located_format_string<detail::ez_arg_value_t<std::remove_reference_t<Args>>...>;
+#else
     template<typename... Args>
     using format_string_of = std::format_string<detail::ez_arg_value_t<std::remove_reference_t<Args>>...>;
+#endif // EZPRINT_ENABLE_STATS && EZPRINT_ENABLE_DIRECT_FORMAT && __cpp_lib_source_location >= 201907L
 
     template<typename... Args>
     inline std::string sprintf(format_string_of<Args...> fmt, Args&&... args)
     {
-        auto args_tuple = std::forward_as_tuple(detail::ez_arg(args)...);
-        return std::vformat(
-            fmt.get(),
-            std::apply([](auto&... args) { return std::make_format_args(args...); }, args_tuple)
+        detail::stats_scope<Args...> stats(fmt);
+        auto s = detail::with_format_args(
+            [&](auto fargs) { return std::vformat(fmt.get(), fargs); }, args...
         );
+        stats.add_bytes(s.size());
+        return s;
     }
 
+#if EZPRINT_ENABLE_DIRECT_FORMAT
     template<typename... Args>
     inline void fprintf(std::ostream& os, format_string_of<Args...> fmt, Args&&... args)
     {
-        auto args_tuple = std::forward_as_tuple(detail::ez_arg(args)...);
-        os << std::vformat(
-            fmt.get(),
-            std::apply([](auto&... args) { return std::make_format_args(args...); }, args_tuple)
+        std::ostream::sentry s(os);
+        if(!s)
+            return;
+
+        // the width of os applies to the whole output, as it does to a string
+        if(auto width = os.width(0); width != 0)
+        {
+            auto str = sprintf(fmt, std::forward<Args>(args)...);
+            detail::pad_to_width(str, 0, os, width);
+            os.write(str.data(), str.size());
+            return;
+        }
+
+        detail::stats_scope<Args...> stats(fmt);
+        auto out = detail::with_format_args(
+            [&](auto fargs) {
+                return std::vformat_to(stats.wrap(std::ostreambuf_iterator<char>(os)), fmt.get(), fargs);
+            },
+            args...
         );
+        if(stats.unwrap(out).failed())
+            os.setstate(std::ios_base::badbit);
     }
 
+    // prints to f without going through iostreams
     template<typename... Args>
-    inline void printf(format_string_of<Args...> fmt, Args&&... args)
+    inline void fprintf(std::FILE* f, format_string_of<Args...> fmt, Args&&... args)
+    {
+        detail::stats_scope<Args...> stats(fmt);
+        detail::sink_buffer buf(f);
+        detail::with_format_args(
+            [&](auto fargs) { return std::vformat_to(stats.wrap(buf.begin()), fmt.get(), fargs); }, args...
+        );
+    }
+
+#if EZPRINT_ENABLE_POSIX
+    // prints to the file descriptor fd without going through iostreams or stdio
+    template<typename... Args>
+    inline void dprintf(int fd, format_string_of<Args...> fmt, Args&&... args)
     {
-        auto args_tuple = std::forward_as_tuple(detail::ez_arg(args)...);
-        std::cout << std::vformat(
-            fmt.get(),
-            std::apply([](auto&... args) { return std::make_format_args(args...); }, args_tuple)
+        detail::stats_scope<Args...> stats(fmt);
+        detail::sink_buffer buf(detail::fd_sink{fd});
+        detail::with_format_args(
+            [&](auto fargs) { return std::vformat_to(stats.wrap(buf.begin()), fmt.get(), fargs); }, args...
         );
     }
+#endif // EZPRINT_ENABLE_POSIX
+#else
+    template<typename... Args>
+    inline void fprintf(std::ostream& os, format_string_of<Args...> fmt, Args&&... args)
+    {
+        os << sprintf(fmt, std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    inline void fprintf(std::FILE* f, format_string_of<Args...> fmt, Args&&... args)
+    {
+        detail::write_all(f, sprintf(fmt, std::forward<Args>(args)...));
+    }
+
+#if EZPRINT_ENABLE_POSIX
+    template<typename... Args>
+    inline void dprintf(int fd, format_string_of<Args...> fmt, Args&&... args)
+    {
+        detail::write_all(detail::fd_sink{fd}, sprintf(fmt, std::forward<Args>(args)...));
+    }
+#endif // EZPRINT_ENABLE_POSIX
+#endif // EZPRINT_ENABLE_DIRECT_FORMAT
+
+    template<typename... Args>
+    inline void printf(format_string_of<Args...> fmt, Args&&... args)
+    {
+        fprintf(std::cout, fmt, std::forward<Args>(args)...);
+    }
+
+#if EZPRINT_ENABLE_DIRECT_FORMAT
+    // prints directly into the format context
+    // fill, alignment and static width are handled by measuring the output first,
+    // other specifications fall back to formatting the string from sprint
+    template<typename T>
+    struct formatter : std::formatter<std::string_view>
+    {
+        template<class ParseCtx>
+        constexpr ParseCtx::iterator parse(ParseCtx& pc)
+        {
+            auto it = pc.begin();
+            auto end = pc.end();
+            auto is_align = [](char c) { return c == '<' || c == '^' || c == '>'; };
+
+            // fill is one code point, which takes up to 4 bytes in UTF-8
+            auto lead = it != end ? static_cast<unsigned char>(*it) : 0;
+            std::ptrdiff_t fill_len = lead >= 0xf0 ? 4 : lead >= 0xe0 ? 3 : lead >= 0xc0 ? 2 : 1;
+            if(end - it > fill_len && is_align(it[fill_len]))
+            {
+                fill = {std::to_address(it), static_cast<size_t>(fill_len)};
+                align = it[fill_len];
+                it += fill_len + 1;
+            }
+            else if(it != end && is_align(*it))
+                align = *it++;
+
+            for(; it != end && '0' <= *it && *it <= '9'; ++it)
+                width = width * 10 + (*it - '0');
+            if(it != end && *it == 's')
+                ++it;
+            materialize = it != end && *it != '}';
+
+            return std::formatter<std::string_view>::parse(pc);
+        }
+
+        template<class Ctx>
+        Ctx::iterator format(T& x, Ctx& ctx) const
+        {
+            if(materialize)
+                return std::formatter<std::string_view>::format(sprint(x), ctx);
+            if(width == 0)
+                return ez::format_to(ctx.out(), x);
+
+            auto size = ez::format_to(detail::ascii_counting_iterator{}, x);
+            if(!size.ascii)
+                return std::formatter<std::string_view>::format(sprint(x), ctx);
+
+            auto pad = width > size.n ? width - size.n : 0;
+            auto left = align == '>' ? pad : align == '^' ? pad / 2 : 0;
+            auto out = ctx.out();
+            for(size_t i = 0; i < left; i++)
+                out = std::copy(fill.begin(), fill.end(), out);
+            out = ez::format_to(out, x);
+            for(size_t i = left; i < pad; i++)
+                out = std::copy(fill.begin(), fill.end(), out);
+            return out;
+        }
 
+    private:
+        std::string_view fill = " ";
+        char align = '<';
+        size_t width = 0;
+        bool materialize = false;
+    };
+#else
     template<typename T>
     struct formatter : std::formatter<std::string>
     {
@@ -469,10 +4360,47 @@ namespace ez
             return std::formatter<std::string>::format(sprint(x), ctx);
         }
     };
+#endif // EZPRINT_ENABLE_DIRECT_FORMAT
 
 #endif // EZPRINT_ENABLE_FORMAT
-#undef EZPRINT_ENABLE_FORMAT
 
-} // namespace ez
+EZPRINT_END_NAMESPACE // ez
+
+#if EZPRINT_ENABLE_DIRECT_FORMAT
+// the format specification of an ez_value applies to each of its leaves
+// nested replacement fields are not supported since leaves are parsed when printed
+template<typename T>
+struct std::formatter<ez::detail::ez_value<T>, char>
+{
+    constexpr std::format_parse_context::iterator parse(std::format_parse_context& pc)
+    {
+        auto it = pc.begin();
+        for(; it != pc.end() && *it != '}'; ++it)
+            if(*it == '{')
+                throw std::format_error("ez: nested replacement fields are not supported");
+        spec = std::string_view(pc.begin(), it);
+        return it;
+    }
+
+    template<class Ctx>
+    Ctx::iterator format(const ez::detail::ez_value<T>& v, Ctx& ctx) const
+    {
+        ez::detail::spec_writer<Ctx> w(ctx, spec);
+        ez::detail::fprint(w, v.x);
+        return w.out();
+    }
+
+private:
+    std::string_view spec;
+};
+#endif // EZPRINT_ENABLE_DIRECT_FORMAT
+#undef EZPRINT_ENABLE_FORMAT
+#undef EZPRINT_ENABLE_DIRECT_FORMAT
+#undef EZPRINT_ENABLE_POSIX
+#undef EZPRINT_ENABLE_STATS
+#undef EZPRINT_ENABLE_ASYNC
+#undef EZPRINT_ENABLE_THREADS
+#undef EZPRINT_BEGIN_NAMESPACE
+#undef EZPRINT_END_NAMESPACE
 
 #endif // EZPRINT_HPP_INCLUDED
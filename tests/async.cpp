@@ -0,0 +1,83 @@
+// every line passed to an async_printer is either printed or counted as dropped, also when
+// it is shut down while other threads are still printing, and the copies of the arguments
+// are destroyed even when printing them throws
+#define EZPRINT_ASYNC
+#include "../ezprint.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <sstream>
+
+// counts its live copies, and throws when printed
+struct throwing
+{
+    static inline std::atomic<int> alive{0};
+    throwing() { alive++; }
+    throwing(const throwing&) { alive++; }
+    ~throwing() { alive--; }
+};
+
+std::ostream& operator<<(std::ostream& os, const throwing&)
+{
+    throw 1;
+    return os;
+}
+
+static size_t count_lines(const std::ostringstream& os)
+{
+    auto s = os.str();
+    return std::count(s.begin(), s.end(), '\n');
+}
+
+int main()
+{
+    constexpr size_t nthreads = 4;
+    constexpr size_t nlines = 2000;
+
+    for(int round = 0; round < 20; round++)
+    {
+        std::ostringstream os;
+        ez::async_printer printer(os, 16, ez::overflow_policy::block);
+        std::vector<std::thread> threads;
+        for(size_t t = 0; t < nthreads; t++)
+            threads.emplace_back([&] {
+                for(size_t i = 0; i < nlines; i++)
+                    printer.println(std::string(20, 'x'), std::vector{1, 2, 3});
+            });
+        std::this_thread::sleep_for(std::chrono::microseconds(round * 100));
+        printer.shutdown();
+        for(auto& t : threads)
+            t.join();
+
+        assert(count_lines(os) + printer.dropped() == nthreads * nlines);
+        // returns right away instead of waiting for a consumer that is gone
+        printer.flush();
+    }
+
+    std::ostringstream os;
+    ez::async_printer printer(os, 4, ez::overflow_policy::block);
+    std::vector<std::thread> threads;
+    for(size_t t = 0; t < nthreads; t++)
+        threads.emplace_back([&, t] {
+            for(size_t i = 0; i < nlines; i++)
+                printer.println(t, i);
+        });
+    for(auto& t : threads)
+        t.join();
+    printer.flush();
+    assert(count_lines(os) == nthreads * nlines && printer.dropped() == 0);
+
+    // the first stored in the queue, the second on the heap
+    {
+        std::ostringstream os;
+        {
+            ez::async_printer printer(os);
+            printer.println(throwing{});
+            printer.println(throwing{}, std::array<char, 200>{});
+            printer.println("after");
+            printer.flush();
+        }
+        assert(throwing::alive == 0);
+        assert(os.str() == "after\n");
+    }
+}
@@ -0,0 +1,79 @@
+// lines printed with ez::atomic from many threads into one stream come out whole,
+// and the time taken is printed next to plain fprintln behind a mutex held by the caller
+#define EZPRINT_THREADS
+#include "../ezprint.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+struct Point
+{
+    int x, y;
+};
+
+constexpr int threads = 8;
+constexpr int lines = 20'000;
+
+// runs print(os, t, i) for every line of every thread, returns the output and the time taken
+template <typename F>
+static std::pair<std::string, double> run(F print)
+{
+    std::ostringstream os;
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::vector<std::thread> pool;
+        for(int t = 0; t < threads; t++)
+            pool.emplace_back([&, t] {
+                for(int i = 0; i < lines; i++)
+                    print(os, t, i);
+            });
+        for(auto& th : pool)
+            th.join();
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return {os.str(), elapsed.count()};
+}
+
+// every line is one of ours, whole, and each one shows up exactly once
+static void check(const std::string& out)
+{
+    std::vector<int> next(threads, 0);
+    std::istringstream is(out);
+    std::string line;
+    int n = 0;
+    while(std::getline(is, line))
+    {
+        int t, i;
+        std::istringstream ls(line);
+        char c;
+        ls >> t >> c >> i;
+        assert(ls && c == ':' && 0 <= t && t < threads);
+        // lines of one thread keep their order
+        assert(i == next[t]);
+        next[t]++;
+        assert(line == ez::sprint(t, ':', i, std::array{Point{i, t}, Point{t, i}}, "end"));
+        n++;
+    }
+    assert(n == threads * lines);
+}
+
+int main()
+{
+    auto [atomic, atomic_ms] = run([](std::ostream& os, int t, int i) {
+        ez::fprintln(ez::atomic, os, t, ':', i, std::array{Point{i, t}, Point{t, i}}, "end");
+    });
+    check(atomic);
+
+    std::mutex m;
+    auto [locked, locked_ms] = run([&](std::ostream& os, int t, int i) {
+        std::lock_guard lock(m);
+        ez::fprintln(os, t, ':', i, std::array{Point{i, t}, Point{t, i}}, "end");
+    });
+    check(locked);
+
+    std::cout << "atomic: " << atomic_ms << "ms, fprintln behind a mutex: " << locked_ms << "ms, "
+              << threads << " threads x " << lines << " lines\n";
+}
@@ -0,0 +1,86 @@
+// cached_view returns what sprint prints for the value, after touching elements whose text
+// changes length, within a chunk and across chunks, and after the range grows or shrinks
+#include "../ezprint.hpp"
+
+#include <cassert>
+
+struct Point
+{
+    int x, y;
+};
+
+static_assert(!std::is_constructible_v<ez::cached_view<std::vector<int>>, std::vector<int>>);
+static_assert(!std::is_constructible_v<ez::cached_view<std::vector<int>>, const std::vector<int>>);
+static_assert(std::is_constructible_v<ez::cached_view<std::vector<int>>, std::vector<int>&>);
+
+int main()
+{
+    constexpr size_t chunk = ez::cached_view<std::vector<int>>::chunk;
+
+    std::vector<int> v(3 * chunk + 10);
+    for(size_t i = 0; i < v.size(); i++)
+        v[i] = static_cast<int>(i);
+    ez::cached_view view(v);
+    assert(view.get() == ez::sprint(v));
+
+    // within one chunk, longer and shorter
+    v[chunk + 5] = -1234567;
+    view.touch(chunk + 5);
+    assert(view.get() == ez::sprint(v));
+    v[chunk + 5] = 7;
+    v[chunk + 6] = 123456789;
+    view.touch(chunk + 5);
+    view.touch(chunk + 6);
+    assert(view.get() == ez::sprint(v));
+
+    // several chunks at once, including the first, the last partial one and their edges,
+    // where the shift of each splice moves the chunks after it
+    for(size_t i : {size_t(0), chunk - 1, 2 * chunk, v.size() - 1})
+    {
+        v[i] = v[i] * 1000 + 999;
+        view.touch(i);
+    }
+    assert(view.get() == ez::sprint(v));
+    for(size_t i : {size_t(0), chunk - 1, v.size() - 1})
+    {
+        v[i] = 1;
+        view.touch(i);
+    }
+    assert(view.get() == ez::sprint(v));
+
+    // untouched changes are only seen once invalidated
+    v[10] = 424242;
+    assert(view.get() != ez::sprint(v));
+    view.invalidate();
+    assert(view.get() == ez::sprint(v));
+
+    // grows into a new chunk and shrinks back
+    v.push_back(5);
+    assert(view.get() == ez::sprint(v));
+    v.resize(chunk);
+    assert(view.get() == ez::sprint(v));
+    view.touch(chunk - 1);
+    v[chunk - 1] = -1;
+    view.touch(chunk + 100);
+    assert(view.get() == ez::sprint(v));
+    v.clear();
+    assert(view.get() == "{}");
+
+    // strings, and values that aren't ranges
+    std::vector<std::string> words(2 * chunk, "word");
+    ez::cached_view word_view(words);
+    assert(word_view.get() == ez::sprint(words));
+    words[chunk] = "";
+    word_view.touch(chunk);
+    words[chunk + 1] = "a much longer word";
+    word_view.touch(chunk + 1);
+    assert(word_view.get() == ez::sprint(words));
+
+    Point p{1, 2};
+    ez::cached_view point_view(p);
+    assert(point_view.get() == "{1 2}");
+    p.x = 100;
+    assert(point_view.get(1) == "{100 2}");
+    p.y = 200;
+    assert(point_view.get(1) == "{100 2}" && point_view.get(2) == "{100 200}");
+}
@@ -0,0 +1,74 @@
+// decode prints what println would have, and rejects malformed logs without throwing
+#include "../ezprint.hpp"
+
+#include <cassert>
+#include <map>
+#include <random>
+#include <sstream>
+
+struct Point
+{
+    int x, y;
+};
+
+static bool decode(const std::string& log, std::string& text)
+{
+    std::istringstream is(log);
+    std::ostringstream os;
+    bool ok = ez::decode(is, os);
+    text = os.str();
+    return ok;
+}
+
+int main()
+{
+    // schemas used before the log exists don't affect its numbering
+    std::ostringstream unused;
+    ez::capture_log(unused).println(1.5, 'c');
+
+    std::ostringstream log;
+    std::ostringstream want;
+    {
+        ez::capture_log cl(log);
+        std::map<std::string, Point> m{{"a", {1, 2}}, {"b", {3, 4}}};
+        std::vector<std::tuple<>> empties(3);
+        for(int i = 0; i < 3; i++)
+        {
+            cl.println(i, "x", std::vector{1.5, 2.5}, m, empties);
+            ez::fprintln(want, i, "x", std::vector{1.5, 2.5}, m, empties);
+            cl.println(Point{i, -i}, std::string("s"), true);
+            ez::fprintln(want, Point{i, -i}, std::string("s"), true);
+        }
+    }
+    std::string text;
+    assert(decode(log.str(), text) && text == want.str());
+
+    // huge schema ids, lengths and element counts
+    assert(!decode(std::string("S\xff\xff\xff\xff\xff\xff\xff\xff\x01\x00\x00\x00\x00", 14), text));
+    assert(!decode(std::string("S\x00\xff\xff\xff\x7f", 6), text));
+    std::string empty_range("S\x00\x07\x00\x00\x00" "a\x01rt\x00\x00\x00" "R\x00\x05\x00\x00\x00\xff\xff\xff\xff\x0f", 24);
+    assert(!decode(empty_range, text));
+    empty_range.replace(empty_range.size() - 9, 9, std::string("\x01\x00\x00\x00\x03", 5));
+    assert(decode(empty_range, text) && text == "{{} {} {}}\n");
+
+    // schemas nested deep enough to run out of stack
+    std::string deep = "a\x01" + std::string(1'000'000, 'r') + "c";
+    std::string deep_log = "S" + std::string(1, '\0');
+    for(int i = 0; i < 4; i++)
+        deep_log += static_cast<char>(deep.size() >> (8 * i));
+    deep_log += deep + std::string("R\x00\x01\x00\x00\x00\x01", 7);
+    assert(!decode(deep_log, text));
+
+    // truncated and corrupted logs
+    std::mt19937 rng(1);
+    auto s = log.str();
+    for(size_t n = 0; n < s.size(); n++)
+        decode(s.substr(0, n), text);
+    for(int i = 0; i < 10000; i++)
+    {
+        auto c = s;
+        for(int j = 0; j < 3; j++)
+            c[rng() % c.size()] = static_cast<char>(rng());
+        decode(c, text);
+    }
+}
@@ -0,0 +1,74 @@
+// long strings handed to writev by reference, more than fit in one batch of iovecs, and
+// copied when get of a tuple-like type returns them by value
+#define EZPRINT_POSIX
+#include "../ezprint.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+// tuple-like, with a get returning copies that are gone before they are written
+// with Nested its first element is a pair, so that it is printed through a skeleton
+template <bool Nested>
+struct copies
+{
+    std::string s;
+};
+
+template <size_t I, bool Nested>
+auto get(const copies<Nested>& c)
+{
+    if constexpr(I == 0 && Nested)
+        return std::pair{c.s, 1};
+    else
+        return c.s;
+}
+
+template <bool Nested>
+struct std::tuple_size<copies<Nested>> : std::integral_constant<size_t, 2>
+{
+};
+
+template <size_t I, bool Nested>
+struct std::tuple_element<I, copies<Nested>>
+{
+    using type = decltype(get<I>(std::declval<const copies<Nested>&>()));
+};
+
+static std::string read_file(const char* path)
+{
+    std::ifstream f(path);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    return ss.str();
+}
+
+int main()
+{
+    char path[] = "/tmp/ezprint_dprint_XXXXXX";
+    int fd = ::mkstemp(path);
+    assert(fd >= 0);
+
+    std::vector<std::string> refs(100, std::string(200, 'a'));
+    std::vector<std::string> mixed;
+    for(int i = 0; i < 300; i++)
+        mixed.push_back(std::string(i % 2 ? 150 : 3, char('a' + i % 26)));
+
+    std::vector<copies<false>> flat;
+    std::vector<copies<true>> nested;
+    for(int i = 0; i < 50; i++)
+    {
+        flat.push_back({std::string(200, char('a' + i % 26))});
+        nested.push_back({std::string(200, char('a' + i % 26))});
+    }
+
+    ez::dprintln(fd, refs);
+    ez::dprintln(fd, mixed, 1, "x");
+    ez::dprintln(fd, flat, nested);
+    ::close(fd);
+
+    assert(read_file(path) == ez::sprint(refs) + "\n" + ez::sprint(mixed, 1, "x") + "\n" +
+                                  ez::sprint(flat, nested) + "\n");
+    std::remove(path);
+}
@@ -0,0 +1,23 @@
+// empty tuples and aggregates, alone and nested, print as {}
+#include "../ezprint.hpp"
+
+#include <cassert>
+
+struct Empty
+{
+};
+
+struct Nested
+{
+    std::tuple<> t;
+    Empty e;
+    int x;
+};
+
+int main()
+{
+    assert(ez::sprint(std::tuple<>{}) == "{}");
+    assert(ez::sprint(Empty{}) == "{}");
+    assert(ez::sprint(Nested{}) == "{{} {} 0}");
+    assert(ez::sprint(std::tuple<std::tuple<>, int>{}) == "{{} 0}");
+}
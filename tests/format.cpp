@@ -0,0 +1,79 @@
+// ez::formatter and the arguments of ez::sprintf std::format can't format going through
+// ez::sprint, and ez::fprintf and ez::dprintf writing the string of ez::sprintf, as they do
+// without EZPRINT_DIRECT_FORMAT
+// needs C++20 and <format>, without them there is nothing to check
+#define EZPRINT_POSIX
+#include "../ezprint.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+
+#if __cpp_lib_format >= 201907L
+struct Point
+{
+    int x, y;
+};
+
+struct Doubles
+{
+    double a, b;
+};
+
+struct Tagged
+{
+    int n;
+    std::string name;
+};
+
+template <>
+struct std::formatter<Point> : ez::formatter<Point>
+{
+};
+
+// what print prints to a temporary file
+template <typename F>
+static std::string printed(F print)
+{
+    std::FILE* f = std::tmpfile();
+    print(f);
+    std::fflush(f);
+    std::rewind(f);
+    std::string s;
+    for(int c; (c = std::fgetc(f)) != EOF;)
+        s += static_cast<char>(c);
+    std::fclose(f);
+    return s;
+}
+
+int main()
+{
+    Point p{1, 2};
+    assert(std::format("{}", p) == "{1 2}");
+    assert(std::format("{:>7}|{:<6}|", p, p) == "  {1 2}|{1 2} |");
+    assert(std::format("{:*^9}", p) == "**{1 2}**");
+    assert(std::format("{:.3}", p) == "{1 ");
+
+    // the specification applies to the whole string
+    assert(ez::sprintf("{:.2f} {}", 1., Doubles{1.25, 2.5}) == "1.00 {1.25 2.5}");
+    assert(ez::sprintf("{:>12}|", Doubles{1.25, 2.5}) == "  {1.25 2.5}|");
+    assert(ez::sprintf("{0} {0}", Tagged{1, "a"}) == "{1 a} {1 a}");
+    assert(ez::sprintf("{} {}", p, Tagged{1, "a"}) == "{1 2} {1 a}");
+
+    std::ostringstream os;
+    os << std::setw(8);
+    ez::fprintf(os, "{}", Tagged{1, "a"});
+    ez::fprintf(os, "|{:>4}|", 1);
+    assert(os.str() == "   {1 a}|   1|");
+
+    assert(printed([](std::FILE* f) { ez::fprintf(f, "{} {}\n", Tagged{1, "a"}, 2); }) == "{1 a} 2\n");
+    assert(printed([](std::FILE* f) { ez::dprintf(::fileno(f), "{} {}\n", Tagged{1, "a"}, 2); }) ==
+           "{1 a} 2\n");
+    std::string long_line(10000, 'x');
+    assert(printed([&](std::FILE* f) { ez::fprintf(f, "{} {}", Tagged{1, long_line}, 2); }) ==
+           "{1 " + long_line + "} 2");
+}
+#else
+int main() {}
+#endif // __cpp_lib_format >= 201907L
@@ -0,0 +1,101 @@
+// ez::formatter formatting straight into the output with EZPRINT_DIRECT_FORMAT, which has to
+// print the same as it does through ez::sprint, and the format specifications of ez::sprintf
+// applying to each leaf of arguments std::format can't format, ez::fprintf and ez::dprintf
+// printing the same as ez::sprintf, and stats kept per call site
+// needs C++20 and <format>, without them there is nothing to check
+#define EZPRINT_DIRECT_FORMAT
+#define EZPRINT_POSIX
+#define EZPRINT_STATS
+#include "../ezprint.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+
+#if __cpp_lib_format >= 201907L
+struct Point
+{
+    int x, y;
+};
+
+struct Doubles
+{
+    double a, b;
+};
+
+struct Tagged
+{
+    int n;
+    std::string name;
+};
+
+template <>
+struct std::formatter<Point> : ez::formatter<Point>
+{
+};
+
+// what print prints to a temporary file
+template <typename F>
+static std::string printed(F print)
+{
+    std::FILE* f = std::tmpfile();
+    print(f);
+    std::fflush(f);
+    std::rewind(f);
+    std::string s;
+    for(int c; (c = std::fgetc(f)) != EOF;)
+        s += static_cast<char>(c);
+    std::fclose(f);
+    return s;
+}
+
+int main()
+{
+    Point p{1, 2};
+    assert(std::format("{}", p) == "{1 2}");
+    assert(std::format("{:>7}|{:<6}|", p, p) == "  {1 2}|{1 2} |");
+    assert(std::format("{:*^9}", p) == "**{1 2}**");
+    assert(std::format("{:é>7}", p) == "éé{1 2}");
+    assert(std::format("{:3}", p) == "{1 2}");
+    // measured by std::format from the string, since they are more than fill and width
+    assert(std::format("{:.3}", p) == "{1 ");
+
+    std::string s;
+    std::format_to(std::back_inserter(s), "{} {:>6}", p, p);
+    assert(s == "{1 2}  {1 2}");
+
+    assert(ez::sprintf("{:.1f}", Doubles{1.25, 2.5}) == "{1.2 2.5}");
+    assert(ez::sprintf("{:.2f} {}", 1., Doubles{1.25, 2.5}) == "1.00 {1.25 2.5}");
+    assert(ez::sprintf("{:>4}", Tagged{1, "ab"}) == "{   1   ab}");
+    // invalid for strings, which are printed as usual
+    assert(ez::sprintf("{:x}", Tagged{255, "s"}) == "{ff s}");
+    assert(ez::sprintf("{0} {0:x}", Tagged{255, "s"}) == "{255 s} {ff s}");
+    assert(ez::sprintf("{} {:.2f}", Tagged{1, "a"}, 1.5) == "{1 a} 1.50");
+
+    std::ostringstream os;
+    os << std::setw(8);
+    ez::fprintf(os, "{}", Tagged{1, "a"});
+    ez::fprintf(os, "|{:>4}|", 1);
+    assert(os.str() == "   {1 a}|   1|");
+
+    assert(printed([](std::FILE* f) { ez::fprintf(f, "{} {}\n", Tagged{1, "a"}, 2); }) == "{1 a} 2\n");
+    assert(printed([](std::FILE* f) { ez::dprintf(::fileno(f), "{} {}\n", Tagged{1, "a"}, 2); }) ==
+           "{1 a} 2\n");
+    std::string long_line(10000, 'x');
+    assert(printed([&](std::FILE* f) { ez::fprintf(f, "{} {}", Tagged{1, long_line}, 2); }) ==
+           "{1 " + long_line + "} 2");
+
+#if __cpp_lib_source_location >= 201907L
+    for(int i = 0; i < 2; i++)
+        ez::sprintf("{}", Doubles{1, 2});
+    size_t sites = 0;
+    for(auto& e : ez::stats_snapshot().sites)
+        if(e.name.find("format_direct.cpp") != std::string::npos && e.calls == 2 && e.bytes == 10)
+            sites++;
+    assert(sites == 1);
+#endif // __cpp_lib_source_location >= 201907L
+}
+#else
+int main() {}
+#endif // __cpp_lib_format >= 201907L
@@ -0,0 +1,50 @@
+// format_to and format_to_n write to any output iterator of char, and argument dependent lookup
+// of a format_to with something else as its first argument finds another one
+#include "../ezprint.hpp"
+
+#include <cassert>
+#include <iterator>
+#include <sstream>
+
+namespace other
+{
+    struct sink
+    {
+        std::string text;
+    };
+
+    struct format_string
+    {
+        format_string(const char* s) : s(s) {}
+        const char* s;
+    };
+
+    // the format_to of another library, with a format string converted from a literal as
+    // std::format_to has
+    template <typename... Ts>
+    void format_to(sink& out, format_string fmt, Ts&&...)
+    {
+        out.text = fmt.s;
+    }
+}
+
+int main()
+{
+    std::string s;
+    ez::format_to(std::back_inserter(s), 1, std::vector{2, 3});
+    assert(s == "1 {2 3}");
+
+    std::ostringstream os;
+    ez::format_to(std::ostreambuf_iterator<char>(os), "text");
+    assert(os.str() == "text");
+
+    char buf[4];
+    auto res = ez::format_to_n(buf, sizeof(buf), std::vector{1, 2, 3});
+    assert(res.size == 7 && res.out == buf + 4 && std::string_view(buf, 4) == "{1 2");
+    assert(ez::formatted_size(std::vector{1, 2, 3}) == 7);
+
+    // ez::limits makes ez::format_to a candidate, which needs no conversion of the literal
+    other::sink sink;
+    format_to(sink, "{}", ez::limits{});
+    assert(sink.text == "{}");
+}
@@ -0,0 +1,29 @@
+// limits set on a stream apply to every way of printing to it
+#define EZPRINT_THREADS
+#include "../ezprint.hpp"
+
+#include <cassert>
+#include <sstream>
+
+int main()
+{
+    std::vector<int> v(10);
+    std::string want = "{0 0 0 ... (+7)}\n";
+
+    std::ostringstream a;
+    ez::set_limits(a, ez::limits{3});
+    ez::fprintln(a, v);
+    assert(a.str() == want);
+
+    std::ostringstream b;
+    ez::set_limits(b, ez::limits{3});
+    ez::fprintln(ez::atomic, b, v);
+    assert(b.str() == want);
+
+    std::ostringstream c;
+    ez::set_limits(c, ez::limits{3});
+    ez::fprintln(ez::parallel, c, v);
+    assert(c.str() == want);
+
+    assert(ez::sprint(ez::limits{SIZE_MAX, SIZE_MAX, 5}, "abcdefgh") == "abcde...");
+}
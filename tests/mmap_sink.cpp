@@ -0,0 +1,58 @@
+// mmap_sink writes what sprint returns across extents, appends, and is cut to size on close
+#define EZPRINT_POSIX
+#include "../ezprint.hpp"
+
+#include <cassert>
+#include <fstream>
+#include <sstream>
+
+struct Point
+{
+    int x, y;
+};
+
+static std::string read_file(const char* path)
+{
+    std::ifstream f(path);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    return ss.str();
+}
+
+int main()
+{
+    char path[] = "/tmp/ezprint_mmap_XXXXXX";
+    ::close(::mkstemp(path));
+
+    std::vector<Point> v(100'000);
+    for(int i = 0; i < static_cast<int>(v.size()); i++)
+        v[i] = {i, -i};
+    auto want = ez::sprint(v, "tail") + "\n";
+    {
+        ez::mmap_sink sink(path, {4096});
+        ez::fprintln(sink, v, "tail");
+        assert(sink.good());
+    }
+    assert(read_file(path) == want);
+
+    {
+        ez::mmap_options opt;
+        opt.append = true;
+        opt.reserve = 1 << 20;
+        opt.extent = 1;
+        ez::mmap_sink sink(path, opt);
+        ez::fprint(sink, std::string(10'000, 'x'));
+        assert(sink.size() == want.size() + 10'000);
+    }
+    assert(read_file(path) == want + std::string(10'000, 'x'));
+
+    {
+        ez::mmap_sink sink(path);
+    }
+    assert(read_file(path).empty());
+    std::remove(path);
+
+    ez::mmap_sink bad("/nonexistent/ezprint");
+    ez::fprintln(bad, 1, 2);
+    assert(!bad.good() && bad.size() == 0);
+}
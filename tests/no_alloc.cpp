@@ -0,0 +1,103 @@
+// sprint_to with enough capacity, sprint into a pmr arena and sprint_n don't allocate for
+// common shapes, also with a global locale that prints numbers as the classic one does,
+// counted by replacing the global operator new
+#include "../ezprint.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+
+static size_t allocations = 0;
+
+void* operator new(std::size_t n)
+{
+    allocations++;
+    if(void* p = std::malloc(n ? n : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+struct Point
+{
+    int x, y;
+};
+
+struct grouping : std::numpunct<char>
+{
+    char do_thousands_sep() const override { return ','; }
+    std::string do_grouping() const override { return "\3"; }
+};
+
+// allocations made by f
+template <typename F>
+static size_t count_allocations(F f)
+{
+    auto before = allocations;
+    f();
+    return allocations - before;
+}
+
+template <typename... Ts>
+static void check(const std::string& want, const Ts&... ts)
+{
+    std::string s;
+    s.reserve(256);
+    assert(count_allocations([&] { ez::sprint_to(s, ts...); }) == 0);
+    assert(s == want);
+
+    char arena[1024];
+    std::pmr::monotonic_buffer_resource resource(arena, sizeof(arena), std::pmr::null_memory_resource());
+    assert(count_allocations([&] {
+               auto p = ez::sprint(std::allocator_arg, std::pmr::polymorphic_allocator<char>(&resource), ts...);
+               assert(std::string_view(p) == want);
+           }) == 0);
+
+    assert(count_allocations([&] {
+               auto f = ez::sprint_n<64>(ts...);
+               assert(f.view() == want && f.overflow() == 0);
+           }) == 0);
+}
+
+int main()
+{
+    // the counter does see allocations
+    assert(count_allocations([] { ez::sprint(std::array<int, 100>{}); }) > 0);
+
+    check("{1 2}", Point{1, 2});
+    check("{1 2 3 4}", std::array{1, 2, 3, 4});
+    check("{1 2.5 c 1}", std::tuple{1, 2.5, 'c', true});
+    check("{{1 2} {3 4}} 5", std::array{Point{1, 2}, Point{3, 4}}, 5u);
+
+    auto cut = ez::sprint_n<3>(std::array{1, 2, 3, 4});
+    assert(cut.view() == "{1 " && cut.overflow() == 6);
+
+    // only the numbers taken from the classic locale, which comparing locales tells by their
+    // names, allocating
+    try
+    {
+        std::locale::global(std::locale(std::locale("C.UTF-8"), std::locale::classic(), std::locale::numeric));
+        check("{1 2} 1.5", Point{1, 2}, 1.5);
+    }
+    catch(const std::runtime_error&)
+    {
+        // C.UTF-8 isn't installed
+    }
+
+    // numbers of other locales are still printed by the stream
+    std::locale::global(std::locale(std::locale::classic(), new grouping));
+    assert(ez::sprint(1234567, std::vector{1000, 1}) == "1,234,567 {1,000 1}");
+    std::locale::global(std::locale::classic());
+
+    // also after the stream that remembers its locale is imbued with another one
+    std::ostringstream os;
+    ez::fprint(os, 1000);
+    os.imbue(std::locale(std::locale::classic(), new grouping));
+    ez::fprint(os << ' ', 1000);
+    assert(os.str() == "1000 1,000");
+}
@@ -0,0 +1,40 @@
+// ez::parallel prints the same as fprint, also with limits and a width set on the stream
+#define EZPRINT_THREADS
+#include "../ezprint.hpp"
+
+#include <cassert>
+#include <iomanip>
+#include <sstream>
+
+struct Point
+{
+    int x, y;
+};
+
+template <typename F>
+static std::string print_to(F f)
+{
+    std::ostringstream os;
+    f(os);
+    return os.str();
+}
+
+int main()
+{
+    std::vector<Point> v(200'000);
+    for(int i = 0; i < static_cast<int>(v.size()); i++)
+        v[i] = {i, -i};
+
+    auto serial = print_to([&](auto& os) { ez::fprintln(os, 1, v, "x"); });
+    auto parallel = print_to([&](auto& os) { ez::fprintln(ez::parallel, os, 1, v, "x"); });
+    assert(parallel == serial);
+
+    auto limited = [&](auto& os) { ez::set_limits(os, ez::limits{5}); };
+    serial = print_to([&](auto& os) { limited(os); ez::fprint(os, v); });
+    parallel = print_to([&](auto& os) { limited(os); ez::fprint(ez::parallel, os, v); });
+    assert(parallel == serial && serial.size() < 100);
+
+    serial = print_to([&](auto& os) { os << std::setw(3); ez::fprint(os, v); });
+    parallel = print_to([&](auto& os) { os << std::setw(3); ez::fprint(ez::parallel, os, v); });
+    assert(parallel == serial);
+}
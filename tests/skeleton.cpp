@@ -0,0 +1,58 @@
+// tuples and aggregates are printed with their precomputed punctuation only when they nest
+// other tuples or aggregates, and print the same either way
+#include "../ezprint.hpp"
+
+#include <cassert>
+
+struct Point
+{
+    int x, y;
+};
+
+struct Segment
+{
+    Point a, b;
+};
+
+struct Named
+{
+    std::string name;
+    std::vector<Point> points;
+};
+
+using ez::detail::use_skeleton;
+
+// flat ones have nothing to merge
+static_assert(!use_skeleton<Point&>());
+static_assert(!use_skeleton<std::tuple<int, double, char>&>());
+static_assert(!use_skeleton<std::tuple<>&>());
+static_assert(!use_skeleton<std::pair<int, std::string>&>());
+// ranges are slots, not nesting
+static_assert(!use_skeleton<Named&>());
+static_assert(!use_skeleton<std::tuple<int, std::vector<Point>>&>());
+// nested ones do
+static_assert(use_skeleton<Segment&>());
+static_assert(use_skeleton<const Segment&>());
+static_assert(use_skeleton<std::tuple<int, Point>&>());
+static_assert(use_skeleton<std::tuple<std::tuple<>, int>&>());
+static_assert(use_skeleton<std::pair<Point, Segment>&>());
+// leaves and ranges never
+static_assert(!use_skeleton<int&>());
+static_assert(!use_skeleton<std::vector<Segment>&>());
+
+// the limited path never uses the skeleton
+template <typename... Ts>
+static void check(const std::string& want, const Ts&... ts)
+{
+    assert(ez::sprint(ts...) == want);
+    assert(ez::sprint(ez::limits{}, ts...) == want);
+}
+
+int main()
+{
+    check("{1 2}", Point{1, 2});
+    check("{{1 2} {3 4}}", Segment{{1, 2}, {3, 4}});
+    check("{1 {2 3}} {{} 4}", std::tuple{1, Point{2, 3}}, std::tuple{std::tuple{}, 4});
+    check("{a {{1 2} {3 4}}}", Named{"a", {{1, 2}, {3, 4}}});
+    check("{{{1 2} {3 4}} {{5 6} {7 8}}}", std::pair{Segment{{1, 2}, {3, 4}}, Segment{{5, 6}, {7, 8}}});
+}
@@ -0,0 +1,33 @@
+// stats count calls, bytes and leaves per argument types, summed over threads
+#define EZPRINT_STATS
+#include "../ezprint.hpp"
+
+#include <cassert>
+#include <sstream>
+#include <thread>
+
+struct Point
+{
+    int x, y;
+};
+
+static const ez::stats_entry* find(const std::vector<ez::stats_entry>& entries, std::string_view name)
+{
+    for(auto& e : entries)
+        if(e.name == name)
+            return &e;
+    return nullptr;
+}
+
+int main()
+{
+    std::ostringstream os;
+    ez::fprint(os, Point{1, 2});
+    std::thread([] { ez::sprint(Point{3, 4}); }).join();
+    ez::sprint(std::vector{1, 2, 3});
+
+    auto stats = ez::stats_snapshot();
+    auto point = find(stats.types, "Point");
+    assert(point && point->calls == 2 && point->bytes == 10 && point->elements == 4);
+    assert(!ez::sprint(stats).empty());
+}
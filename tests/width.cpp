@@ -0,0 +1,64 @@
+// the width of the stream applies to what is printed first, as with operator<<
+#define EZPRINT_THREADS
+#include "../ezprint.hpp"
+
+#include <cassert>
+#include <iomanip>
+#include <sstream>
+
+struct Point
+{
+    int x, y;
+};
+
+template <typename F>
+static std::string print_to(F f)
+{
+    std::ostringstream os;
+    f(os);
+    os << "|";
+    return os.str();
+}
+
+int main()
+{
+    assert(print_to([](auto& os) {
+               os << std::setw(6);
+               ez::fprint(os, 1, "x");
+           }) == "     1 x|");
+    assert(print_to([](auto& os) {
+               os << std::setw(8) << std::setfill('.');
+               ez::fprint(os, std::vector{1, 2});
+           }) == ".......{1 2}|");
+    assert(print_to([](auto& os) {
+               os << std::left << std::setw(6) << std::setfill('.');
+               ez::fprint(os, std::string("ab"), 3);
+           }) == "ab.... 3|");
+    assert(print_to([](auto& os) {
+               os << std::internal << std::showpos << std::setw(6);
+               ez::fprint(os, -1, 2);
+           }) == "-    1 +2|");
+    assert(print_to([](auto& os) {
+               os << std::setw(4);
+               ez::fprint(os, Point{1, 2});
+           }) == "   {1 2}|");
+    assert(print_to([](auto& os) {
+               ez::set_limits(os, ez::limits{2});
+               os << std::setw(3);
+               ez::fprintln(os, std::vector{1, 2, 3});
+           }) == "  {1 2 ... (+1)}\n|");
+    assert(print_to([](auto& os) {
+               os << std::setw(4);
+               ez::fprintln(ez::atomic, os, 1, 2);
+           }) == "   1 2\n|");
+    assert(print_to([](auto& os) {
+               os << std::setw(4);
+               ez::fprint(ez::parallel, os, std::vector<int>(3000, 1));
+           }).substr(0, 7) == "   {1 1");
+
+    // and is reset once applied
+    std::ostringstream os;
+    os << std::setw(3);
+    ez::fprint(os, std::vector{1, 2});
+    assert(os.str() == "  {1 2}" && os.width() == 0);
+}
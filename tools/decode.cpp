@@ -0,0 +1,26 @@
+// prints the lines of capture_log files, or of standard input without arguments
+#include "../ezprint.hpp"
+
+#include <fstream>
+
+int main(int argc, char** argv)
+{
+    std::ios::sync_with_stdio(false);
+    if(argc < 2)
+        return ez::decode(std::cin, std::cout) ? 0 : 1;
+
+    for(int i = 1; i < argc; i++)
+    {
+        std::ifstream is(argv[i], std::ios::binary);
+        if(!is)
+        {
+            std::cerr << argv[0] << ": can't open " << argv[i] << '\n';
+            return 1;
+        }
+        if(!ez::decode(is, std::cout))
+        {
+            std::cerr << argv[0] << ": " << argv[i] << " is malformed\n";
+            return 1;
+        }
+    }
+}